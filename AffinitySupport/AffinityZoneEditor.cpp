@@ -1,10 +1,12 @@
-// Copyright (c) 2014-2021 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #include "MainWindow/FormLayout.hpp"
 #include "AffinitySupport/AffinityZoneEditor.hpp"
 #include "AffinitySupport/CpuSelectionWidget.hpp"
 #include "HostExplorer/HostExplorerDock.hpp"
+#include "EvalEngine/EnvironmentHeartbeat.hpp"
+#include "EvalEngine/EnvironmentPool.hpp"
 #include <Pothos/Remote.hpp>
 #include <Pothos/Proxy.hpp>
 #include <Poco/Logger.h>
@@ -19,6 +21,8 @@
 #include <cassert>
 
 static const int ARBITRARY_MAX_THREADS = 4096;
+static const int MAX_HEARTBEAT_INTERVAL_MS = 60000;
+static const int MAX_ENVIRONMENT_POOL_SIZE = 16;
 
 AffinityZoneEditor::AffinityZoneEditor(const QString &zoneName, QWidget *parent, HostExplorerDock *hostExplorer):
     QWidget(parent),
@@ -31,7 +35,9 @@ AffinityZoneEditor::AffinityZoneEditor(const QString &zoneName, QWidget *parent,
     _prioritySpin(new QSpinBox(this)),
     _cpuSelection(nullptr),
     _cpuSelectionContainer(new QVBoxLayout()),
-    _yieldModeBox(new QComboBox(this))
+    _yieldModeBox(new QComboBox(this)),
+    _heartbeatSpin(new QSpinBox(this)),
+    _envPoolSpin(new QSpinBox(this))
 {
     assert(_hostExplorerDock != nullptr);
 
@@ -117,6 +123,26 @@ AffinityZoneEditor::AffinityZoneEditor(const QString &zoneName, QWidget *parent,
         _yieldModeBox->setToolTip(tr("Yield mode specifies the internal threading mechanisms"));
         connect(_yieldModeBox, QOverload<int>::of(&QComboBox::activated), this, &AffinityZoneEditor::handleComboChanged);
     }
+
+    //heartbeat interval
+    {
+        formLayout->addRow(tr("Heartbeat interval"), _heartbeatSpin);
+        _heartbeatSpin->setRange(100, MAX_HEARTBEAT_INTERVAL_MS);
+        _heartbeatSpin->setSingleStep(100);
+        _heartbeatSpin->setSuffix(tr(" ms"));
+        _heartbeatSpin->setValue(DEFAULT_HEARTBEAT_INTERVAL_MS);
+        _heartbeatSpin->setToolTip(tr("Interval between liveness checks of the remote environment"));
+        connect(_heartbeatSpin, &QSpinBox::editingFinished, this, &AffinityZoneEditor::handleSpinSelChanged);
+    }
+
+    //warm environment pool
+    {
+        formLayout->addRow(tr("Warm environments"), _envPoolSpin);
+        _envPoolSpin->setRange(0, MAX_ENVIRONMENT_POOL_SIZE);
+        _envPoolSpin->setValue(DEFAULT_ENVIRONMENT_POOL_SIZE);
+        _envPoolSpin->setToolTip(tr("Number of pre-spawned environments to keep ready on the host, 0 means disabled"));
+        connect(_envPoolSpin, &QSpinBox::editingFinished, this, &AffinityZoneEditor::handleSpinSelChanged);
+    }
 }
 
 QColor AffinityZoneEditor::color(void) const
@@ -189,6 +215,14 @@ void AffinityZoneEditor::loadFromConfig(const QJsonObject &config)
             if (_yieldModeBox->itemData(i).toString() == mode) _yieldModeBox->setCurrentIndex(i);
         }
     }
+    if (config.contains("heartbeatIntervalMs"))
+    {
+        _heartbeatSpin->setValue(config["heartbeatIntervalMs"].toInt());
+    }
+    if (config.contains("environmentPoolSize"))
+    {
+        _envPoolSpin->setValue(config["environmentPoolSize"].toInt());
+    }
 }
 
 QJsonObject AffinityZoneEditor::getCurrentConfig(void) const
@@ -205,6 +239,8 @@ QJsonObject AffinityZoneEditor::getCurrentConfig(void) const
     for (auto num : _cpuSelection->selection()) affinity.push_back(num);
     config["affinity"] = affinity;
     config["yieldMode"] = _yieldModeBox->itemData(_yieldModeBox->currentIndex()).toString();
+    config["heartbeatIntervalMs"] = _heartbeatSpin->value();
+    config["environmentPoolSize"] = _envPoolSpin->value();
     return config;
 }
 
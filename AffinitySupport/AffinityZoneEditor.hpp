@@ -1,4 +1,4 @@
-// Copyright (c) 2014-2017 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #pragma once
@@ -90,6 +90,8 @@ private:
     CpuSelectionWidget *_cpuSelection;
     QVBoxLayout *_cpuSelectionContainer;
     QComboBox *_yieldModeBox;
+    QSpinBox *_heartbeatSpin;
+    QSpinBox *_envPoolSpin;
 
     std::map<QString, std::vector<Pothos::System::NumaInfo>> _uriToNumaInfo;
 };
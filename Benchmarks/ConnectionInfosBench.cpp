@@ -0,0 +1,77 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "EvalEngine/ConnectionInfo.hpp"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <chrono>
+#include <iostream>
+#include <cstdlib> //std::atoi
+#include <string>
+
+/***********************************************************************
+ * Micro-benchmark for connection info operations used by TopologyEval:
+ * The diff is called twice per evaluation pass, and insert and remove
+ * are called for every connection change in the active topology.
+ * Usage: ConnectionInfosBench [numConnections=10000]
+ **********************************************************************/
+static ConnectionInfos makeConnections(const size_t num, const size_t offset)
+{
+    ConnectionInfos infos;
+    for (size_t i = 0; i < num; i++)
+    {
+        ConnectionInfo info;
+        info.srcBlockUID = i+offset;
+        info.dstBlockUID = i+offset+1;
+        info.srcPort = "out" + QString::number(i%4);
+        info.dstPort = "in" + QString::number(i%4);
+        infos.insert(info);
+    }
+    return infos;
+}
+
+template <typename Fcn>
+static double timeUs(Fcn &&fcn)
+{
+    const auto t0 = std::chrono::high_resolution_clock::now();
+    fcn();
+    const auto t1 = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::micro>(t1 - t0).count();
+}
+
+int main(int argc, char **argv)
+{
+    const size_t num = (argc > 1)? size_t(std::atoi(argv[1])) : 10000;
+    QJsonObject results;
+    results["numConnections"] = double(num);
+
+    //the new connections overlap the current connections by 90%
+    ConnectionInfos current, next;
+    results["insertUs"] = timeUs([&]{current = makeConnections(num, 0);});
+    next = makeConnections(num, num/10);
+
+    ConnectionInfos removed, added;
+    results["diffUs"] = timeUs([&]
+    {
+        removed = diffConnectionInfos(current, next);
+        added = diffConnectionInfos(next, current);
+    });
+    results["numRemoved"] = double(removed.size());
+    results["numAdded"] = double(added.size());
+
+    results["applyUs"] = timeUs([&]
+    {
+        for (const auto &conn : removed) current.remove(conn);
+        for (const auto &conn : added) current.insert(conn);
+    });
+
+    ConnectionInfos copy;
+    results["copyUs"] = timeUs([&]{copy = current;});
+
+    //sanity check the result of applying the diff
+    const bool ok = (current.size() == next.size()) and diffConnectionInfos(current, next).empty();
+    results["ok"] = ok;
+
+    std::cout << QJsonDocument(results).toJson(QJsonDocument::Indented).toStdString();
+    return ok?EXIT_SUCCESS:EXIT_FAILURE;
+}
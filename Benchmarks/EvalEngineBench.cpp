@@ -0,0 +1,307 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "MainWindow/MainWindow.hpp"
+#include "GraphEditor/GraphEditorTabs.hpp"
+#include "GraphEditor/GraphEditor.hpp"
+#include "EvalEngine/TopologyEval.hpp"
+#include "EvalEngine/EvalMetrics.hpp"
+#include <Pothos/System.hpp>
+#include <QCommandLineParser>
+#include <QTemporaryFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QApplication>
+#include <QFile>
+#include <QDir>
+#include <chrono>
+#include <iostream>
+#include <algorithm> //max
+#include <cstdlib> //EXIT_FAILURE
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/***********************************************************************
+ * Benchmark for the evaluation pipeline on synthetic designs:
+ * A design with N blocks, M block connections, K breaker nodes,
+ * C global constants, and Z affinity zones is generated and run through
+ * the same graph editor and eval engine as the GUI (headless mode).
+ * Each phase is timed until the eval thread finished processing it,
+ * and the results are printed as JSON to track across releases.
+ *
+ * The zones are named but not configured, so they share the default
+ * local managed environment and only differ in their thread pools.
+ * Peak memory is for this process, the blocks live in the environment.
+ **********************************************************************/
+struct DesignParams
+{
+    int numBlocks;
+    int numConnections;
+    int numBreakers;
+    int numConstants;
+    int numZones;
+    QString blockPath;
+    QString paramKey;
+};
+
+static QJsonObject makeBlock(const DesignParams &p, const int i)
+{
+    QJsonObject param;
+    param["key"] = p.paramKey;
+    param["value"] = (p.numConstants > 0)?QString("C%1").arg(i % p.numConstants):QString("0");
+
+    QJsonObject block;
+    block["what"] = QString("Block");
+    block["id"] = QString("b%1").arg(i);
+    block["path"] = p.blockPath;
+    block["affinityZone"] = QString("bench%1").arg(i % std::max(1, p.numZones));
+    block["properties"] = QJsonArray({param});
+    block["positionX"] = (i % 32)*200.0;
+    block["positionY"] = (i / 32)*100.0;
+    return block;
+}
+
+static QJsonObject makeConnection(const QString &id, const QString &srcId, const QString &dstId)
+{
+    QJsonObject conn;
+    conn["what"] = QString("Connection");
+    conn["id"] = id;
+    conn["outputId"] = srcId;
+    conn["outputKey"] = QString("0");
+    conn["inputId"] = dstId;
+    conn["inputKey"] = QString("0");
+    return conn;
+}
+
+static QJsonObject makeBreaker(const int k, const bool isInput)
+{
+    QJsonObject breaker;
+    breaker["what"] = QString("Breaker");
+    breaker["id"] = QString(isInput?"ib%1":"ob%1").arg(k);
+    breaker["nodeName"] = QString("node%1").arg(k);
+    breaker["isInput"] = isInput;
+    return breaker;
+}
+
+static QByteArray makeDesign(const DesignParams &p)
+{
+    QJsonArray globals;
+    for (int k = 0; k < p.numConstants; k++)
+    {
+        QJsonObject globalObj;
+        globalObj["name"] = QString("C%1").arg(k);
+        globalObj["value"] = QString("0");
+        globals.push_back(globalObj);
+    }
+
+    QJsonArray graphObjects;
+    for (int i = 0; i < p.numBlocks; i++) graphObjects.push_back(makeBlock(p, i));
+    if (p.numBlocks > 1)
+    {
+        //spread the connections across the blocks, never a self loop
+        for (int j = 0; j < p.numConnections; j++)
+        {
+            const int src = j % p.numBlocks;
+            int dst = (j + 1 + j/p.numBlocks) % p.numBlocks;
+            if (dst == src) dst = (dst + 1) % p.numBlocks;
+            graphObjects.push_back(makeConnection(QString("c%1").arg(j),
+                QString("b%1").arg(src), QString("b%1").arg(dst)));
+        }
+
+        //each breaker node relays a block to the far side of the design
+        for (int k = 0; k < p.numBreakers; k++)
+        {
+            graphObjects.push_back(makeBreaker(k, false));
+            graphObjects.push_back(makeBreaker(k, true));
+            graphObjects.push_back(makeConnection(QString("obc%1").arg(k),
+                QString("b%1").arg(k % p.numBlocks), QString("ob%1").arg(k)));
+            graphObjects.push_back(makeConnection(QString("ibc%1").arg(k),
+                QString("ib%1").arg(k), QString("b%1").arg((k + p.numBlocks/2) % p.numBlocks)));
+        }
+    }
+
+    QJsonObject page;
+    page["pageName"] = QString("Main");
+    page["selected"] = true;
+    page["graphObjects"] = graphObjects;
+
+    QJsonObject topObj;
+    topObj["globals"] = globals;
+    topObj["pages"] = QJsonArray({page});
+    return QJsonDocument(topObj).toJson(QJsonDocument::Indented);
+}
+
+static double peakMemoryKb(void)
+{
+    #ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (not GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0.0;
+    return counters.PeakWorkingSetSize/1024.0;
+    #else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+    #ifdef __APPLE__
+    return usage.ru_maxrss/1024.0; //bytes on OSX
+    #else
+    return double(usage.ru_maxrss); //kilobytes on Linux
+    #endif
+    #endif
+}
+
+template <typename Fcn>
+static double timeMs(Fcn &&fcn)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    fcn();
+    const auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+int main(int argc, char **argv)
+{
+    //graph widgets still need a platform, render them off screen
+    if (not qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    app.setApplicationName("Pothos");
+    app.setOrganizationName("PothosWare");
+    app.setOrganizationDomain("www.pothosware.com");
+    app.setApplicationVersion(QString::fromStdString(Pothos::System::getApiVersion()));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmark the evaluation pipeline with a synthetic design");
+    parser.addHelpOption();
+    QCommandLineOption blocksOption("blocks", "Number of blocks", "N", "100");
+    QCommandLineOption connectionsOption("connections", "Number of block to block connections", "M", "100");
+    QCommandLineOption breakersOption("breakers", "Number of breaker nodes (input and output pair)", "K", "10");
+    QCommandLineOption constantsOption("constants", "Number of global constants", "C", "10");
+    QCommandLineOption zonesOption("zones", "Number of affinity zones", "Z", "1");
+    QCommandLineOption editsOption("edits", "Number of incremental constant edits", "E", "10");
+    QCommandLineOption blockOption("block", "Block path with a port 0 on both sides", "path", "/blocks/delay");
+    QCommandLineOption paramOption("param", "Block parameter set from the constants", "key", "delay");
+    QCommandLineOption saveOption("save", "Also save the synthetic design to this file", "file");
+    parser.addOptions({blocksOption, connectionsOption, breakersOption,
+        constantsOption, zonesOption, editsOption, blockOption, paramOption, saveOption});
+    parser.process(app);
+
+    DesignParams params;
+    params.numBlocks = parser.value(blocksOption).toInt();
+    params.numConnections = parser.value(connectionsOption).toInt();
+    params.numBreakers = parser.value(breakersOption).toInt();
+    params.numConstants = parser.value(constantsOption).toInt();
+    params.numZones = parser.value(zonesOption).toInt();
+    params.blockPath = parser.value(blockOption);
+    params.paramKey = parser.value(paramOption);
+    const int numEdits = (params.numConstants > 0)?parser.value(editsOption).toInt():0;
+
+    //write the design to a file so it loads like a user topology
+    const auto design = makeDesign(params);
+    QTemporaryFile designFile(QDir::temp().filePath("EvalEngineBenchXXXXXX.pothos"));
+    if (not designFile.open() or designFile.write(design) == -1 or not designFile.flush())
+    {
+        std::cerr << "Error writing design: " << designFile.errorString().toStdString() << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (parser.isSet(saveOption))
+    {
+        QFile saveFile(parser.value(saveOption));
+        if (saveFile.open(QFile::WriteOnly)) saveFile.write(design);
+    }
+
+    QJsonObject designObj;
+    designObj["numBlocks"] = params.numBlocks;
+    designObj["numConnections"] = params.numConnections;
+    designObj["numBreakers"] = params.numBreakers;
+    designObj["numConstants"] = params.numConstants;
+    designObj["numZones"] = params.numZones;
+    designObj["numEdits"] = numEdits;
+    designObj["blockPath"] = params.blockPath;
+
+    QJsonObject phases;
+    POTHOS_EXCEPTION_TRY
+    {
+        MainWindow mainWindow(nullptr, true/*headless*/);
+        EvalMetrics::global().reset();
+
+        //a blocking query waits for the eval thread to process everything before it
+        GraphEditor *editor = nullptr;
+        const auto waitForEval = [&](void)
+        {
+            editor->getTopologyJSONStats();
+            QApplication::processEvents(); //deliver status to the blocks
+        };
+
+        phases["loadMs"] = timeMs([&]
+        {
+            editor = mainWindow.getEditorTabs()->openFile(designFile.fileName());
+            waitForEval();
+        });
+
+        const auto graphObjects = editor->getGraphObjects();
+        const int numIters = 10;
+        phases["getConnectionInfoMs"] = timeMs([&]
+        {
+            for (int i = 0; i < numIters; i++) TopologyEval::getConnectionInfo(graphObjects);
+        })/numIters;
+
+        phases["submitUnchangedMs"] = timeMs([&]
+        {
+            editor->commitGlobalsChanges();
+            waitForEval();
+        });
+
+        editor->stopEvaluation();
+        phases["submitTopologyMs"] = timeMs([&]
+        {
+            editor->restartEvaluation();
+            waitForEval();
+        });
+
+        phases["activateMs"] = timeMs([&]
+        {
+            editor->setTopologyActive(true);
+            waitForEval();
+        });
+        designObj["activated"] = editor->isTopologyActive();
+
+        double editTotalMs(0.0), editMaxMs(0.0);
+        for (int e = 0; e < numEdits; e++)
+        {
+            const auto editMs = timeMs([&]
+            {
+                editor->setGlobalExpression(QString("C%1").arg(e % params.numConstants), QString::number((e/params.numConstants)+1));
+                editor->commitGlobalsChanges();
+                waitForEval();
+            });
+            editTotalMs += editMs;
+            editMaxMs = std::max(editMaxMs, editMs);
+        }
+        if (numEdits > 0) phases["incrementalEditMs"] = editTotalMs/numEdits;
+        phases["incrementalEditMaxMs"] = editMaxMs;
+
+        phases["deactivateMs"] = timeMs([&]
+        {
+            editor->setTopologyActive(false);
+            waitForEval();
+        });
+    }
+    POTHOS_EXCEPTION_CATCH (const Pothos::Exception &ex)
+    {
+        std::cerr << "EvalEngineBench error: " << ex.displayText() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    QJsonObject results;
+    results["design"] = designObj;
+    results["phases"] = phases;
+    results["evalMetrics"] = EvalMetrics::global().toJSON();
+    results["peakMemoryKb"] = peakMemoryKb();
+    std::cout << QJsonDocument(results).toJson(QJsonDocument::Indented).toStdString();
+    return EXIT_SUCCESS;
+}
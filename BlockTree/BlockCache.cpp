@@ -1,42 +1,174 @@
-// Copyright (c) 2014-2017 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #include "BlockTree/BlockCache.hpp"
 #include "HostExplorer/HostExplorerDock.hpp"
+#include "HostExplorer/PluginModuleUtils.hpp"
 #include "MainWindow/MainSplash.hpp"
+#include <Pothos/System.hpp>
 #include <Pothos/Remote.hpp>
 #include <Pothos/Proxy.hpp>
+#include <Pothos/Plugin.hpp>
 #include <QJsonDocument>
+#include <QCryptographicHash>
+#include <QSaveFile>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDir>
 #include <QFuture>
 #include <QFutureWatcher>
 #include <QReadWriteLock>
+#include <QTimer>
 #include <QtConcurrent/QtConcurrent>
 #include <Poco/Logger.h>
 #include <iostream>
 #include <map>
 
+//! Failed lookups are not repeated until this many milliseconds elapsed
+static const int FAILED_LOOKUP_EXPIRY_MS = 60000;
+
+/***********************************************************************
+ * Persistent block descriptions on disk:
+ * One file per host URI holds the block descriptions of the host
+ * and a fingerprint of the modules that were loaded on the host.
+ * The files are served at startup while the hosts are revalidated,
+ * and the descriptions are only dumped again when the modules change.
+ **********************************************************************/
+static QString getBlockDescCachePath(const QString &uri)
+{
+    const QDir dataDir(QString::fromStdString(Pothos::System::getUserDataPath()));
+    const auto name = QCryptographicHash::hash(uri.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return dataDir.absoluteFilePath(QString("PothosFlow/BlockCache/%1.json").arg(QString(name)));
+}
+
+static HostBlockDescs loadBlockDescCache(const QString &uri)
+{
+    HostBlockDescs result;
+    result.uri = uri;
+    QFile cacheFile(getBlockDescCachePath(uri));
+    if (not cacheFile.open(QFile::ReadOnly)) return result;
+    const auto topObj = QJsonDocument::fromJson(cacheFile.readAll()).object();
+    if (topObj["uri"].toString() != uri) return result; //not a match or malformed
+    result.fingerprint = topObj["fingerprint"].toString();
+    result.blockDescs = topObj["blockDescs"].toArray();
+    return result;
+}
+
+static void storeBlockDescCache(const HostBlockDescs &descs)
+{
+    const auto cachePath = getBlockDescCachePath(descs.uri);
+    QDir().mkpath(QFileInfo(cachePath).absolutePath());
+
+    QJsonObject topObj;
+    topObj["uri"] = descs.uri;
+    topObj["fingerprint"] = descs.fingerprint;
+    topObj["blockDescs"] = descs.blockDescs;
+
+    //write to the side and commit so a reader never sees a partial file
+    QSaveFile cacheFile(cachePath);
+    if (not cacheFile.open(QFile::WriteOnly) or
+        cacheFile.write(QJsonDocument(topObj).toJson(QJsonDocument::Compact)) == -1 or
+        not cacheFile.commit())
+    {
+        static auto &logger = Poco::Logger::get("PothosFlow.BlockCache");
+        logger.warning("Failed to store block cache %s - %s", cachePath.toStdString(), cacheFile.errorString().toStdString());
+    }
+}
+
+/***********************************************************************
+ * Fingerprint the loaded modules and versions of a node
+ **********************************************************************/
+static QString queryModuleFingerprint(Pothos::ProxyEnvironment::Sptr env)
+{
+    const Pothos::PluginRegistryInfoDump dump = env->findProxy("Pothos/PluginRegistry").call("dump");
+    std::map<std::string, std::string> modVers;
+    loadModuleVersions(modVers, dump);
+
+    //a module rebuilt in place may keep the same path and version,
+    //so the module files on this node also add their size and mtime
+    const Pothos::System::HostInfo hostInfo = env->findProxy("Pothos/System/HostInfo").call("get");
+    const bool isLocalNode = hostInfo.nodeId == Pothos::System::HostInfo::get().nodeId;
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (const auto &pair : modVers)
+    {
+        auto entry = QString::fromStdString(pair.first + "=" + pair.second);
+        if (isLocalNode and not pair.first.empty())
+        {
+            const QFileInfo moduleFile(QString::fromStdString(pair.first));
+            entry += QString(";%1;%2").arg(moduleFile.size()).arg(moduleFile.lastModified().toMSecsSinceEpoch());
+        }
+        hash.addData((entry + "\n").toUtf8());
+    }
+    return QString(hash.result().toHex());
+}
+
 /***********************************************************************
  * Query JSON docs from node
  **********************************************************************/
-static QJsonArray queryBlockDescs(const QString &uri)
+static HostBlockDescs queryBlockDescs(const HostBlockDescs &last)
 {
+    static auto &logger = Poco::Logger::get("PothosFlow.BlockCache");
     try
     {
-        auto client = Pothos::RemoteClient(uri.toStdString());
+        auto client = Pothos::RemoteClient(last.uri.toStdString());
         auto env = client.makeEnvironment("managed");
+
+        //the same modules are loaded, the descriptions are up to date
+        HostBlockDescs result;
+        result.uri = last.uri;
+        result.fingerprint = queryModuleFingerprint(env);
+        if (result.fingerprint == last.fingerprint) return last;
+
         const std::string json = env->findProxy("Pothos/Util/DocUtils").call("dumpJson");
         QJsonParseError errorParser;
         const auto jsonDoc = QJsonDocument::fromJson(QByteArray(json.data(), json.size()), &errorParser);
         if (jsonDoc.isNull()) throw Pothos::Exception(errorParser.errorString().toStdString());
-        return jsonDoc.array();
+        result.blockDescs = jsonDoc.array();
+        storeBlockDescCache(result);
+        return result;
     }
     catch (const Pothos::Exception &ex)
     {
-        static auto &logger = Poco::Logger::get("PothosFlow.BlockCache");
-        logger.warning("Failed to query JSON Docs from %s - %s", uri.toStdString(), ex.displayText());
+        logger.warning("Failed to query JSON Docs from %s - %s", last.uri.toStdString(), ex.displayText());
     }
 
-    return QJsonArray(); //empty JSON array
+    //keep the last known descriptions of an unreachable host
+    return last;
+}
+
+/***********************************************************************
+ * Lookup uncached block descriptions on a node
+ **********************************************************************/
+static HostBlockLookup lookupBlockDescs(const HostBlockLookup &query)
+{
+    HostBlockLookup result = query;
+    try
+    {
+        //one connection per host for all of the paths in the batch
+        auto client = Pothos::RemoteClient(query.uri.toStdString());
+        auto env = client.makeEnvironment("managed");
+        auto DocUtils = env->findProxy("Pothos/Util/DocUtils");
+        for (const auto &path : query.paths)
+        {
+            try
+            {
+                const std::string json = DocUtils.call("dumpJsonAt", path.toStdString());
+                const auto jsonDoc = QJsonDocument::fromJson(QByteArray(json.data(), json.size()));
+                if (jsonDoc.isObject()) result.blockDescs[path] = jsonDoc.object();
+            }
+            catch (const Pothos::Exception &)
+            {
+                //pass, the path is not on this host
+            }
+        }
+    }
+    catch (const Pothos::Exception &)
+    {
+        //pass, the host is not reachable
+    }
+    return result;
 }
 
 /***********************************************************************
@@ -52,18 +184,27 @@ BlockCache *BlockCache::global(void)
 BlockCache::BlockCache(QObject *parent, HostExplorerDock *hostExplorer):
     QObject(parent),
     _hostExplorerDock(hostExplorer),
-    _watcher(new QFutureWatcher<QJsonArray>(this)),
-    _mapMutex(new QReadWriteLock())
+    _watcher(new QFutureWatcher<HostBlockDescs>(this)),
+    _mapMutex(new QReadWriteLock()),
+    _lookupWatcher(new QFutureWatcher<HostBlockLookup>(this)),
+    _lookupTimer(new QTimer(this))
 {
     globalBlockCache = this;
     assert(_hostExplorerDock != nullptr);
-    connect(_watcher, &QFutureWatcher<QJsonArray>::resultReadyAt, this, &BlockCache::handleWatcherDone);
-    connect(_watcher, &QFutureWatcher<QJsonArray>::finished, this, &BlockCache::handleWatcherFinished);
+    connect(_watcher, &QFutureWatcher<HostBlockDescs>::resultReadyAt, this, &BlockCache::handleWatcherDone);
+    connect(_watcher, &QFutureWatcher<HostBlockDescs>::finished, this, &BlockCache::handleWatcherFinished);
     connect(_hostExplorerDock, &HostExplorerDock::hostUriListChanged, this, &BlockCache::update);
+
+    //batch the lookups of every path missed until the event loop runs again
+    _lookupTimer->setSingleShot(true);
+    _lookupTimer->setInterval(0);
+    connect(_lookupTimer, &QTimer::timeout, this, &BlockCache::handleLookupTimeout);
+    connect(_lookupWatcher, &QFutureWatcher<HostBlockLookup>::finished, this, &BlockCache::handleLookupFinished);
 }
 
 BlockCache::~BlockCache(void)
 {
+    _lookupWatcher->waitForFinished();
     delete _mapMutex;
 }
 
@@ -74,35 +215,90 @@ QJsonObject BlockCache::getBlockDescFromPath(const QString &path)
         QReadLocker lock(_mapMutex);
         auto it = _pathToBlockDesc.find(path);
         if (it != _pathToBlockDesc.end()) return it->second;
+        auto lookupIt = _pathToLookupDesc.find(path);
+        if (lookupIt != _pathToLookupDesc.end()) return lookupIt->second;
     }
 
-    //search all of the nodes
+    //the path was recently looked up and not found
+    auto failedIt = _failedLookupExpiry.find(path);
+    if (failedIt != _failedLookupExpiry.end())
+    {
+        if (std::chrono::steady_clock::now() < failedIt->second) return QJsonObject();
+        _failedLookupExpiry.erase(failedIt);
+    }
+
+    //search all of the nodes in the background
+    _pendingLookupPaths.insert(path);
+    if (not _lookupTimer->isActive()) _lookupTimer->start();
+    return QJsonObject();
+}
+
+void BlockCache::handleLookupTimeout(void)
+{
+    //one batch at a time, the next starts when this one finishes
+    if (_lookupWatcher->isRunning() or _pendingLookupPaths.isEmpty()) return;
+
+    _activeLookupPaths = _pendingLookupPaths.values();
+    _pendingLookupPaths.clear();
+
+    //queries cannot be a temporary because QtConcurrent will reference them
+    _lookupQueries.clear();
     for (const auto &uri : _hostExplorerDock->hostUriList())
     {
-        try
+        HostBlockLookup query;
+        query.uri = uri;
+        query.paths = _activeLookupPaths;
+        _lookupQueries.push_back(query);
+    }
+    _lookupWatcher->setFuture(QtConcurrent::mapped(_lookupQueries, &lookupBlockDescs));
+}
+
+void BlockCache::handleLookupFinished(void)
+{
+    static auto &logger = Poco::Logger::get("PothosFlow.BlockCache");
+    const auto results = _lookupWatcher->future().results();
+    for (const auto &path : _activeLookupPaths)
+    {
+        //the first host in the list with the path wins
+        QJsonObject blockDesc;
+        for (const auto &result : results)
+        {
+            auto it = result.blockDescs.find(path);
+            if (it == result.blockDescs.end()) continue;
+            blockDesc = it->second;
+            break;
+        }
+
+        if (blockDesc.isEmpty())
         {
-            auto client = Pothos::RemoteClient(uri.toStdString());
-            auto env = client.makeEnvironment("managed");
-            auto DocUtils = env->findProxy("Pothos/Util/DocUtils");
-            const std::string json = DocUtils.call("dumpJsonAt", path.toStdString());
-            QJsonParseError errorParser;
-            const auto jsonDoc = QJsonDocument::fromJson(QByteArray(json.data(), json.size()), &errorParser);
-            if (jsonDoc.isNull()) throw Pothos::Exception(errorParser.errorString().toStdString());
-            return jsonDoc.object();
+            logger.error("Cant find block factory with path: '%s'", path.toStdString());
+            _failedLookupExpiry[path] = std::chrono::steady_clock::now() + std::chrono::milliseconds(FAILED_LOOKUP_EXPIRY_MS);
+            continue;
         }
-        catch (const Pothos::Exception &)
+
         {
-            //pass
+            QWriteLocker lock(_mapMutex);
+            _pathToLookupDesc[path] = blockDesc;
         }
+        emit this->blockDescResolved(path, blockDesc);
     }
+    _activeLookupPaths.clear();
 
-    return QJsonObject();
+    //paths that were missed while this batch was running
+    if (not _pendingLookupPaths.isEmpty()) _lookupTimer->start();
 }
 
 void BlockCache::clear(void)
 {
+    //the host descriptions are kept so the next update delivers a diff,
+    //but the fingerprints are forgotten so every host dumps them again,
+    //a module may have been rebuilt without a change in the fingerprint
+    for (auto &pair : _uriToBlockDescs) pair.second.fingerprint.clear();
+
+    //the individual lookups are forgotten so they are made again
     QWriteLocker lock(_mapMutex);
-    _pathToBlockDesc.clear();
+    _pathToLookupDesc.clear();
+    _failedLookupExpiry.clear();
 }
 
 void BlockCache::update(void)
@@ -114,51 +310,112 @@ void BlockCache::update(void)
     _watcher->cancel();
     _watcher->waitForFinished();
 
-    //nodeKeys cannot be a temporary because QtConcurrent will reference them
+    //serve the descriptions stored on disk for hosts not seen yet,
+    //the hosts are revalidated in the background and only changes apply
     _allRemoteNodeUris = _hostExplorerDock->hostUriList();
-    _watcher->setFuture(QtConcurrent::mapped(_allRemoteNodeUris, &queryBlockDescs));
+    for (const auto &uri : _allRemoteNodeUris)
+    {
+        if (_uriToBlockDescs.count(uri) != 0) continue;
+        _uriToBlockDescs[uri] = loadBlockDescCache(uri);
+        _changedUris.insert(uri);
+    }
+    this->applyBlockDescs();
+
+    //queries cannot be a temporary because QtConcurrent will reference them
+    _hostQueries.clear();
+    for (const auto &uri : _allRemoteNodeUris) _hostQueries.push_back(_uriToBlockDescs.at(uri));
+    _watcher->setFuture(QtConcurrent::mapped(_hostQueries, &queryBlockDescs));
+    _updatePending = true;
 }
 
 void BlockCache::handleWatcherFinished(void)
 {
     MainSplash::global()->postMessage(tr("Block cache updated."));
+    this->applyBlockDescs();
+    _updatePending = false;
+    emit this->blockDescReady();
+}
 
-    //remove old nodes
-    std::map<QString, QJsonArray> newMap;
-    for (const auto &uri : _allRemoteNodeUris) newMap[uri] = _uriToBlockDescs[uri];
-    _uriToBlockDescs = newMap;
-
-    //map paths to block descs
+void BlockCache::applyBlockDescs(void)
+{
+    //paths provided by the removed and changed hosts
+    QSet<QString> affectedPaths;
+    QSet<QString> allUris;
+    for (const auto &uri : _allRemoteNodeUris) allUris.insert(uri);
+    for (auto it = _uriToPathDescs.begin(); it != _uriToPathDescs.end();)
     {
-        QWriteLocker lock(_mapMutex);
-        _pathToBlockDesc.clear();
-        for (const auto &pair : _uriToBlockDescs)
+        auto thisIt = it++; //increment before erase
+        if (allUris.contains(thisIt->first) and not _changedUris.contains(thisIt->first)) continue;
+        for (const auto &pair : thisIt->second) affectedPaths.insert(pair.first);
+        _uriToPathDescs.erase(thisIt);
+    }
+    for (auto it = _uriToBlockDescs.begin(); it != _uriToBlockDescs.end();)
+    {
+        auto thisIt = it++; //increment before erase
+        if (not allUris.contains(thisIt->first)) _uriToBlockDescs.erase(thisIt);
+    }
+    for (const auto &uri : _changedUris)
+    {
+        if (not allUris.contains(uri)) continue;
+        auto &pathDescs = _uriToPathDescs[uri];
+        for (const auto &blockDescVal : _uriToBlockDescs.at(uri).blockDescs)
         {
-            for (const auto &blockDescVal : pair.second)
-            {
-                const auto blockDesc = blockDescVal.toObject();
-                const auto path = blockDesc["path"].toString();
-                _pathToBlockDesc[path] = blockDesc;
-            }
+            const auto blockDesc = blockDescVal.toObject();
+            const auto path = blockDesc["path"].toString();
+            pathDescs[path] = blockDesc;
+            affectedPaths.insert(path);
         }
     }
+    _changedUris.clear();
+    if (affectedPaths.isEmpty()) return;
+
+    //the hosts changed, failed lookups may succeed now
+    _failedLookupExpiry.clear();
 
-    //make a master block desc list
-    QJsonArray superSetBlockDescs;
+    //resolve the affected paths, the last host in order provides the path
+    QJsonArray added, changed;
+    QStringList removed;
     {
-        QReadLocker lock(_mapMutex);
-        for (const auto &pair : _pathToBlockDesc)
+        QWriteLocker lock(_mapMutex);
+        for (const auto &path : affectedPaths)
         {
-            superSetBlockDescs.push_back(pair.second);
+            QJsonObject blockDesc;
+            for (const auto &pair : _uriToPathDescs)
+            {
+                auto it = pair.second.find(path);
+                if (it != pair.second.end()) blockDesc = it->second;
+            }
+
+            auto it = _pathToBlockDesc.find(path);
+            if (blockDesc.isEmpty())
+            {
+                if (it == _pathToBlockDesc.end()) continue;
+                _pathToBlockDesc.erase(it);
+                removed.push_back(path);
+            }
+            else if (it == _pathToBlockDesc.end())
+            {
+                _pathToBlockDesc[path] = blockDesc;
+                added.push_back(blockDesc);
+            }
+            else if (it->second != blockDesc)
+            {
+                it->second = blockDesc;
+                changed.push_back(blockDesc);
+            }
         }
     }
 
     //let the subscribers know
-    emit this->blockDescReady();
-    emit this->blockDescUpdate(superSetBlockDescs);
+    if (added.isEmpty() and changed.isEmpty() and removed.isEmpty()) return;
+    emit this->blockDescChanges(added, changed, removed);
 }
 
 void BlockCache::handleWatcherDone(const int which)
 {
-    _uriToBlockDescs[_allRemoteNodeUris[which]] = _watcher->resultAt(which);
+    const auto result = _watcher->resultAt(which);
+    auto &descs = _uriToBlockDescs[result.uri];
+    if (descs.fingerprint == result.fingerprint) return;
+    descs = result;
+    _changedUris.insert(result.uri);
 }
@@ -1,4 +1,4 @@
-// Copyright (c) 2014-2017 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #pragma once
@@ -9,10 +9,29 @@
 #include <QFutureWatcher>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QSet>
 #include <map>
+#include <chrono>
 
 class HostExplorerDock;
 class QReadWriteLock;
+class QTimer;
+
+//! The block descriptions of a host and the fingerprint of its modules
+struct HostBlockDescs
+{
+    QString uri;
+    QString fingerprint;
+    QJsonArray blockDescs;
+};
+
+//! A batched lookup of block descriptions that are not cached
+struct HostBlockLookup
+{
+    QString uri;
+    QStringList paths;
+    std::map<QString, QJsonObject> blockDescs; //found paths
+};
 
 class BlockCache : public QObject
 {
@@ -26,13 +45,40 @@ public:
 
     ~BlockCache(void);
 
-    //! Get a block description given the block registry path
+    /*!
+     * Get a block description given the block registry path.
+     * A path that is not cached returns an empty description,
+     * and the path is looked up on the hosts in the background.
+     * All paths missed within an event loop iteration are batched
+     * into a single lookup, and blockDescResolved() is emitted per
+     * path found. Paths that are not found are not looked up again
+     * until the failed lookup expires or the block cache updates.
+     */
     QJsonObject getBlockDescFromPath(const QString &path);
 
+    /*!
+     * Is an update of the host block descriptions in progress?
+     * blockDescReady() is emitted when the update completes.
+     */
+    bool isUpdatePending(void) const
+    {
+        return _updatePending;
+    }
+
 signals:
-    void blockDescUpdate(const QJsonArray &);
+    /*!
+     * The block descriptions changed after a host update.
+     * The first update lists all of the descriptions as added.
+     * \param added the descriptions of new block paths
+     * \param changed the new descriptions of existing block paths
+     * \param removed the block paths no longer provided by any host
+     */
+    void blockDescChanges(const QJsonArray &added, const QJsonArray &changed, const QStringList &removed);
     void blockDescReady(void);
 
+    //! A block description that was not cached was found on a host
+    void blockDescResolved(const QString &path, const QJsonObject &desc);
+
 public slots:
     void clear(void);
     void update(void);
@@ -42,13 +88,37 @@ private slots:
 
     void handleWatcherDone(const int which);
 
+    void handleLookupTimeout(void);
+
+    void handleLookupFinished(void);
+
 private:
+    /*!
+     * Apply the removed and changed hosts to the path map,
+     * and notify the subscribers of the paths that changed.
+     * Only the paths provided by those hosts are resolved again.
+     */
+    void applyBlockDescs(void);
+
     HostExplorerDock *_hostExplorerDock;
     QStringList _allRemoteNodeUris;
-    QFutureWatcher<QJsonArray> *_watcher;
+    QList<HostBlockDescs> _hostQueries;
+    QFutureWatcher<HostBlockDescs> *_watcher;
+    bool _updatePending{false};
+    QSet<QString> _changedUris;
 
     //storage structures
     QReadWriteLock *_mapMutex;
-    std::map<QString, QJsonArray> _uriToBlockDescs;
+    std::map<QString, HostBlockDescs> _uriToBlockDescs;
+    std::map<QString, std::map<QString, QJsonObject>> _uriToPathDescs;
     std::map<QString, QJsonObject> _pathToBlockDesc;
+    std::map<QString, QJsonObject> _pathToLookupDesc;
+
+    //background lookups of paths that are not cached
+    QSet<QString> _pendingLookupPaths;
+    QStringList _activeLookupPaths;
+    QList<HostBlockLookup> _lookupQueries;
+    QFutureWatcher<HostBlockLookup> *_lookupWatcher;
+    QTimer *_lookupTimer;
+    std::map<QString, std::chrono::steady_clock::time_point> _failedLookupExpiry;
 };
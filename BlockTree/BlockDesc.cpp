@@ -0,0 +1,54 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "BlockTree/BlockDesc.hpp"
+#include <QJsonArray>
+#include <mutex>
+#include <map>
+
+BlockDesc::BlockDesc(const QJsonObject &json):
+    _json(json),
+    _path(json["path"].toString())
+{
+    for (const auto &arg : json["args"].toArray())
+    {
+        const auto propKey = arg.toString();
+        if (propKey != "remoteEnv") _criticalPropKeys.push_back(propKey);
+    }
+    for (const auto &callVal : json["calls"].toArray())
+    {
+        const auto callObj = callVal.toObject();
+        Call call;
+        call.name = callObj["name"].toString();
+        for (const auto &arg : callObj["args"].toArray()) call.args.push_back(arg.toString());
+        const auto type = callObj["type"].toString();
+        if (type == "initializer")
+        {
+            _criticalPropKeys += call.args;
+            _initializers.push_back(call);
+        }
+        else if (type == "setter") _setters.push_back(call);
+    }
+}
+
+BlockDesc::Sptr BlockDesc::intern(const QJsonObject &json)
+{
+    //descriptions by path, usually one version per path is in use
+    static std::mutex mutex;
+    static std::multimap<QString, std::weak_ptr<const BlockDesc>> pool;
+
+    const auto path = json["path"].toString();
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto range = pool.equal_range(path);
+    for (auto it = range.first; it != range.second;)
+    {
+        auto thisIt = it++; //increment before erase
+        auto desc = thisIt->second.lock();
+        if (not desc) pool.erase(thisIt);
+        else if (desc->getJSON() == json) return desc;
+    }
+
+    Sptr desc(new BlockDesc(json));
+    pool.emplace(path, desc);
+    return desc;
+}
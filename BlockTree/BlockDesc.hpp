@@ -0,0 +1,78 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Config.hpp>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <vector>
+
+/*!
+ * An immutable block description shared by reference.
+ * The JSON description is parsed once into the lists used by evaluation.
+ * Descriptions are interned, so equal descriptions are the same object,
+ * and a change in description is detected by comparing the pointers.
+ */
+class BlockDesc
+{
+public:
+    typedef std::shared_ptr<const BlockDesc> Sptr;
+
+    //! A call on the block with the property keys of its arguments
+    struct Call
+    {
+        QString name;
+        QStringList args;
+    };
+
+    /*!
+     * Get the shared description for a JSON block description.
+     * Equal JSON descriptions return the same object while it is in use.
+     * The descriptions are held weakly and are released when unused.
+     */
+    static Sptr intern(const QJsonObject &json);
+
+    //! The JSON description
+    const QJsonObject &getJSON(void) const
+    {
+        return _json;
+    }
+
+    //! The block factory path
+    const QString &getPath(void) const
+    {
+        return _path;
+    }
+
+    //! The initializer calls made after construction
+    const std::vector<Call> &getInitializers(void) const
+    {
+        return _initializers;
+    }
+
+    //! The setter calls made when their arguments change
+    const std::vector<Call> &getSetters(void) const
+    {
+        return _setters;
+    }
+
+    /*!
+     * The property keys passed to the block constructor and initializers.
+     * A change in any of these properties requires a new block.
+     */
+    const QStringList &getCriticalPropKeys(void) const
+    {
+        return _criticalPropKeys;
+    }
+
+private:
+    BlockDesc(const QJsonObject &json);
+
+    const QJsonObject _json;
+    QString _path;
+    std::vector<Call> _initializers;
+    std::vector<Call> _setters;
+    QStringList _criticalPropKeys;
+};
@@ -0,0 +1,158 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "BlockTree/BlockSearchIndex.hpp"
+#include <QJsonArray>
+#include <QRegularExpression>
+#include <algorithm> //sort, min/max
+#include <vector>
+
+#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
+    #define behavior QString::SkipEmptyParts
+#else
+    #define behavior Qt::SkipEmptyParts //old flags deprecated in 5.14
+#endif
+
+static QSet<QString> getTrigrams(const QString &text)
+{
+    QSet<QString> trigrams;
+    for (int i = 0; i+3 <= text.size(); i++) trigrams.insert(text.mid(i, 3));
+    return trigrams;
+}
+
+static void unindexPath(std::map<QString, QSet<QString>> &index, const QString &key, const QString &path)
+{
+    auto it = index.find(key);
+    if (it == index.end()) return;
+    it->second.remove(path);
+    if (it->second.isEmpty()) index.erase(it);
+}
+
+void BlockSearchIndex::insert(const QJsonObject &blockDesc)
+{
+    const auto path = blockDesc["path"].toString();
+    this->remove(path);
+
+    //the fields of the candidate string, in the order that they are joined
+    QStringList fields;
+    fields.push_back(path);
+    fields.push_back(blockDesc["name"].toString());
+    for (const auto &categoryVal : blockDesc["categories"].toArray())
+    {
+        fields.push_back(categoryVal.toString());
+    }
+    for (const auto &keywordVal : blockDesc["keywords"].toArray())
+    {
+        fields.push_back(keywordVal.toString());
+    }
+
+    static const QRegularExpression nonWord("\\W");
+    auto &entry = _entries[path];
+    entry.candidate = fields.join("").toLower();
+    entry.name = blockDesc["name"].toString().toLower();
+    for (const auto &field : fields)
+    {
+        for (const auto &tok : field.toLower().split(nonWord, behavior)) entry.tokens.insert(tok);
+    }
+
+    for (const auto &tok : entry.tokens) _tokenIndex[tok].insert(path);
+    for (const auto &trigram : getTrigrams(entry.candidate)) _trigramIndex[trigram].insert(path);
+}
+
+void BlockSearchIndex::remove(const QString &path)
+{
+    auto it = _entries.find(path);
+    if (it == _entries.end()) return;
+    for (const auto &tok : it->second.tokens) unindexPath(_tokenIndex, tok, path);
+    for (const auto &trigram : getTrigrams(it->second.candidate)) unindexPath(_trigramIndex, trigram, path);
+    _entries.erase(it);
+}
+
+QSet<QString> BlockSearchIndex::findCandidates(const QString &word) const
+{
+    QSet<QString> matched;
+
+    //too short for trigrams, check every candidate string
+    if (word.size() < 3)
+    {
+        for (const auto &pair : _entries)
+        {
+            if (pair.second.candidate.contains(word)) matched.insert(pair.first);
+        }
+        return matched;
+    }
+
+    //intersect the paths of every trigram in the word, smallest first
+    std::vector<const QSet<QString> *> pathSets;
+    for (const auto &trigram : getTrigrams(word))
+    {
+        auto it = _trigramIndex.find(trigram);
+        if (it == _trigramIndex.end()) return matched;
+        pathSets.push_back(&it->second);
+    }
+    std::sort(pathSets.begin(), pathSets.end(), [](const QSet<QString> *a, const QSet<QString> *b)
+    {
+        return a->size() < b->size();
+    });
+    auto paths = *pathSets.front();
+    for (size_t i = 1; i < pathSets.size() and not paths.isEmpty(); i++)
+    {
+        paths.intersect(*pathSets[i]);
+    }
+
+    //the trigrams may be found apart, confirm the word itself
+    for (const auto &path : paths)
+    {
+        if (_entries.at(path).candidate.contains(word)) matched.insert(path);
+    }
+    return matched;
+}
+
+std::map<QString, int> BlockSearchIndex::search(const QString &filter) const
+{
+    static const QRegularExpression whitespace("\\s+");
+    const auto words = filter.toLower().split(whitespace, behavior);
+
+    std::map<QString, int> matches;
+    for (int i = 0; i < words.size(); i++)
+    {
+        const auto &word = words.at(i);
+
+        //the paths with a token that is or starts with the word
+        const auto exactIt = _tokenIndex.find(word);
+        QSet<QString> prefixPaths;
+        for (auto it = _tokenIndex.lower_bound(word); it != _tokenIndex.end() and it->first.startsWith(word); ++it)
+        {
+            prefixPaths += it->second;
+        }
+
+        //a match is only as good as its worst matching word
+        std::map<QString, int> wordMatches;
+        for (const auto &path : this->findCandidates(word))
+        {
+            if (i != 0 and matches.count(path) == 0) continue;
+            const auto &name = _entries.at(path).name;
+            int rank = SUBSTRING;
+            if (name == word) rank = NAME_EXACT;
+            else if (name.startsWith(word)) rank = NAME_PREFIX;
+            else if (exactIt != _tokenIndex.end() and exactIt->second.contains(path)) rank = TOKEN_EXACT;
+            else if (prefixPaths.contains(path)) rank = TOKEN_PREFIX;
+            wordMatches[path] = (i == 0)?rank:std::max(rank, matches.at(path));
+        }
+        matches.swap(wordMatches);
+        if (matches.empty()) break;
+    }
+
+    //a multiple word filter can still name the block
+    if (words.size() > 1)
+    {
+        const auto phrase = words.join(" ");
+        for (auto &pair : matches)
+        {
+            const auto &name = _entries.at(pair.first).name;
+            if (name == phrase) pair.second = NAME_EXACT;
+            else if (name.startsWith(phrase)) pair.second = std::min<int>(pair.second, NAME_PREFIX);
+        }
+    }
+    return matches;
+}
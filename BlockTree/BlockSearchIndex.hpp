@@ -0,0 +1,63 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Config.hpp>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <QSet>
+#include <map>
+
+/*!
+ * The search index finds block descriptions for the block tree filter.
+ * Each description is searched by the lowercase candidate string made from
+ * its path, name, categories, and keywords, as the filter always has been.
+ * A trigram index narrows the candidates of a search word to a set
+ * intersection, and a token index ranks the matches by quality.
+ * The index is updated per description as the block cache changes.
+ */
+class BlockSearchIndex
+{
+public:
+
+    //! The quality of a match, lower is better
+    enum MatchRank
+    {
+        NAME_EXACT,
+        NAME_PREFIX,
+        TOKEN_EXACT,
+        TOKEN_PREFIX,
+        SUBSTRING,
+        NO_MATCH,
+    };
+
+    //! Add or replace a block description by its path
+    void insert(const QJsonObject &blockDesc);
+
+    //! Remove the block description of a path
+    void remove(const QString &path);
+
+    /*!
+     * Find the block descriptions that match a filter.
+     * Every whitespace separated word of the filter must be
+     * found in the candidate string of a block description.
+     * \return a map of the matching paths to the match rank
+     */
+    std::map<QString, int> search(const QString &filter) const;
+
+private:
+    struct Entry
+    {
+        QString candidate;
+        QString name;
+        QSet<QString> tokens;
+    };
+
+    //! The paths with a candidate that contains the word
+    QSet<QString> findCandidates(const QString &word) const;
+
+    std::map<QString, Entry> _entries;
+    std::map<QString, QSet<QString>> _tokenIndex;
+    std::map<QString, QSet<QString>> _trigramIndex;
+};
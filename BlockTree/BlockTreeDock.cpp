@@ -39,8 +39,8 @@ BlockTreeDock::BlockTreeDock(QWidget *parent, BlockCache *blockCache, GraphEdito
     layout->addWidget(_searchBox);
 
     _blockTree = new BlockTreeWidget(this->widget(), editorTabs);
-    connect(blockCache, SIGNAL(blockDescUpdate(const QJsonArray &)),
-        _blockTree, SLOT(handleBlockDescUpdate(const QJsonArray &)));
+    connect(blockCache, SIGNAL(blockDescChanges(const QJsonArray &, const QJsonArray &, const QStringList &)),
+        _blockTree, SLOT(handleBlockDescChanges(const QJsonArray &, const QJsonArray &, const QStringList &)));
     connect(_blockTree, SIGNAL(blockDescEvent(const QJsonObject &, bool)),
         this, SLOT(handleBlockDescEvent(const QJsonObject &, bool)));
     connect(_searchBox, &QLineEdit::textChanged, _blockTree, &BlockTreeWidget::handleFilter);
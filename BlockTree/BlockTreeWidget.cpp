@@ -1,4 +1,4 @@
-// Copyright (c) 2014-2021 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #include "BlockTree/BlockTreeWidget.hpp"
@@ -17,6 +17,7 @@
 #include <QPainter>
 #include <QJsonDocument>
 #include <memory>
+#include <algorithm> //min
 
 static const long UPDATE_TIMER_MS = 500;
 
@@ -106,19 +107,39 @@ void BlockTreeWidget::mouseMoveEvent(QMouseEvent *event)
     drag->exec(Qt::CopyAction | Qt::MoveAction);
 }
 
-void BlockTreeWidget::handleBlockDescUpdate(const QJsonArray &blockDescs)
+void BlockTreeWidget::handleBlockDescChanges(const QJsonArray &added, const QJsonArray &changed, const QStringList &removed)
 {
-    _blockDescs = blockDescs;
-    this->populate();
+    //only the items of the affected paths are replaced
+    for (const auto &path : removed)
+    {
+        _searchIndex.remove(path);
+        this->removeBlockItems(path);
+    }
+    for (const auto &blockDescs : {added, changed})
+    {
+        for (const auto &blockDescVal : blockDescs)
+        {
+            const auto blockDesc = blockDescVal.toObject();
+            const auto path = blockDesc["path"].toString();
+            _searchIndex.insert(blockDesc);
+            this->removeBlockItems(path);
+            this->addBlockItems(blockDesc);
+        }
+    }
+
+    //the new items are shown by the filter and sorted
+    this->applyFilter();
     this->resizeColumnToContents(0);
 }
 
 void BlockTreeWidget::handleFilterTimerExpired(void)
 {
-    this->clear();
-    _rootNodes.clear();
-    this->populate();
+    //the items are kept, only their visibility and order changes
+    this->applyFilter();
     for (auto item : this->findItems("", Qt::MatchContains, 0)) item->setExpanded(not _filter.isEmpty());
+
+    this->clearSelection();
+    emit this->blockDescEvent(QJsonObject(), false); //unselect
 }
 
 void BlockTreeWidget::handleFilter(const QString &filter)
@@ -145,51 +166,83 @@ void BlockTreeWidget::handleItemDoubleClicked(QTreeWidgetItem *item, int)
     if (b != nullptr) emit blockDescEvent(b->getBlockDesc(), true);
 }
 
-void BlockTreeWidget::populate(void)
+void BlockTreeWidget::applyFilter(void)
+{
+    //an empty filter matches everything, and the ranks are equal
+    std::map<QString, int> matches;
+    const bool filtered = not _filter.trimmed().isEmpty();
+    if (filtered) matches = _searchIndex.search(_filter);
+    for (const auto &pair : _rootNodes) this->applyFilter(pair.second, filtered?&matches:nullptr);
+
+    //sort by match rank, then alphabetically
+    this->sortByColumn(0, Qt::AscendingOrder);
+}
+
+int BlockTreeWidget::applyFilter(BlockTreeWidgetItem *item, const std::map<QString, int> *matches)
 {
-    for (const auto &blockDescVal : _blockDescs)
+    int rank = BlockSearchIndex::NO_MATCH;
+    const auto pathIt = _itemToPath.find(item);
+    if (pathIt != _itemToPath.end())
     {
-        const auto blockDesc = blockDescVal.toObject();
-        if (not this->blockDescMatchesFilter(blockDesc)) continue;
-        const auto path = blockDesc["path"].toString();
-        const auto name = blockDesc["name"].toString();
-        for (const auto &categoryVal : blockDesc["categories"].toArray())
+        if (matches == nullptr) rank = 0;
+        else
         {
-            const auto category = categoryVal.toString().mid(1);
-            const auto key = category.mid(0, category.indexOf('/'));
-            if (_rootNodes.find(key) == _rootNodes.end()) _rootNodes[key] = new BlockTreeWidgetItem(this, key);
-            _rootNodes[key]->load(blockDesc, category + "/" + name);
+            const auto it = matches->find(pathIt->second);
+            if (it != matches->end()) rank = it->second;
         }
     }
 
-    //sort the columns alphabetically
-    this->sortByColumn(0, Qt::AscendingOrder);
+    //a category is as good as its best block
+    for (int i = 0; i < item->childCount(); i++)
+    {
+        auto child = static_cast<BlockTreeWidgetItem *>(item->child(i));
+        rank = std::min(rank, this->applyFilter(child, matches));
+    }
 
-    emit this->blockDescEvent(QJsonObject(), false); //unselect
+    item->setMatchRank(rank);
+    item->setHidden(rank == BlockSearchIndex::NO_MATCH);
+    return rank;
 }
 
-bool BlockTreeWidget::blockDescMatchesFilter(const QJsonObject &blockDesc)
+void BlockTreeWidget::addBlockItems(const QJsonObject &blockDesc)
 {
-    if (_filter.isEmpty()) return true;
-
     const auto path = blockDesc["path"].toString();
     const auto name = blockDesc["name"].toString();
-
-    //construct a candidate string from path, name, categories, and keywords.
-    QString candidate = path+name;
     for (const auto &categoryVal : blockDesc["categories"].toArray())
     {
-        candidate += categoryVal.toString();
+        const auto category = categoryVal.toString().mid(1);
+        const auto key = category.mid(0, category.indexOf('/'));
+        if (_rootNodes.find(key) == _rootNodes.end()) _rootNodes[key] = new BlockTreeWidgetItem(this, key);
+        auto item = _rootNodes[key]->load(blockDesc, category + "/" + name);
+
+        //the item is taken over when another path had the same category and name
+        auto &itemPath = _itemToPath[item];
+        if (itemPath == path) continue; //duplicate category
+        const auto range = _pathToItems.equal_range(itemPath);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second != item) continue;
+            _pathToItems.erase(it);
+            break;
+        }
+        itemPath = path;
+        _pathToItems.emplace(path, item);
     }
-    for (const auto &keywordVal : blockDesc["keywords"].toArray())
+}
+
+void BlockTreeWidget::removeBlockItems(const QString &path)
+{
+    const auto range = _pathToItems.equal_range(path);
+    for (auto it = range.first; it != range.second; ++it)
     {
-        candidate += keywordVal.toString();
+        //an empty top level category is removed from the tree
+        _itemToPath.erase(it->second);
+        auto rootItem = BlockTreeWidgetItem::unload(it->second);
+        if (rootItem == nullptr) continue;
+        _rootNodes.erase(rootItem->text(0));
+        delete rootItem;
     }
-
-    //reject if filter string not found in candidate
-    candidate = candidate.toLower();
-    const auto searchToken = _filter.toLower();
-    return (candidate.indexOf(searchToken) != -1);
+    _pathToItems.erase(range.first, range.second);
 }
 
 QMimeData *BlockTreeWidget::mimeData(const QList<QTreeWidgetItem *> mimeDataRef(items)) const
@@ -1,12 +1,14 @@
-// Copyright (c) 2014-2021 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #pragma once
 #include <Pothos/Config.hpp>
+#include "BlockTree/BlockSearchIndex.hpp"
 #include <QTreeWidget>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QString>
+#include <QStringList>
 #include <QList>
 #include <map>
 
@@ -27,7 +29,7 @@ signals:
     void blockDescEvent(const QJsonObject &, bool);
 
 public slots:
-    void handleBlockDescUpdate(const QJsonArray &blockDescs);
+    void handleBlockDescChanges(const QJsonArray &added, const QJsonArray &changed, const QStringList &removed);
 
     void handleFilter(const QString &filter);
 
@@ -44,9 +46,21 @@ private:
 
     void mouseMoveEvent(QMouseEvent *event) override;
 
-    void populate(void);
+    //! Show the items that match the filter, best matches first
+    void applyFilter(void);
 
-    bool blockDescMatchesFilter(const QJsonObject &blockDesc);
+    /*!
+     * Show or hide an item and its children by the filter matches.
+     * \param matches the match ranks by path or null for all
+     * \return the best match rank of the item and its children
+     */
+    int applyFilter(BlockTreeWidgetItem *item, const std::map<QString, int> *matches);
+
+    //! Add the items of a block description
+    void addBlockItems(const QJsonObject &blockDesc);
+
+    //! Remove the items of a block path and empty categories
+    void removeBlockItems(const QString &path);
 
     //qt6 changed the function signature to be a reference
     #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -62,6 +76,8 @@ private:
     QTimer *_filttimer;
     QPoint _dragStartPos;
     QTreeWidgetItem *_dragItem;
-    QJsonArray _blockDescs;
+    BlockSearchIndex _searchIndex;
     std::map<QString, BlockTreeWidgetItem *> _rootNodes;
+    std::multimap<QString, BlockTreeWidgetItem *> _pathToItems;
+    std::map<BlockTreeWidgetItem *, QString> _itemToPath;
 };
@@ -1,16 +1,17 @@
-// Copyright (c) 2014-2017 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #include "BlockTree/BlockTreeWidgetItem.hpp"
 #include <QJsonArray>
 
-void BlockTreeWidgetItem::load(const QJsonObject &blockDesc, const QString &category, const size_t depth)
+BlockTreeWidgetItem *BlockTreeWidgetItem::load(const QJsonObject &blockDesc, const QString &category, const size_t depth)
 {
     const auto slashIndex = category.indexOf('/');
     const auto catName = category.mid(0, slashIndex);
     if (slashIndex == -1)
     {
         _blockDesc = blockDesc;
+        return this;
     }
     else
     {
@@ -21,10 +22,36 @@ void BlockTreeWidgetItem::load(const QJsonObject &blockDesc, const QString &cate
             _subNodes[key] = new BlockTreeWidgetItem(this, key);
             _subNodes[key]->setExpanded(depth < 2);
         }
-        _subNodes[key]->load(blockDesc, catRest, depth+1);
+        return _subNodes[key]->load(blockDesc, catRest, depth+1);
     }
 }
 
+BlockTreeWidgetItem *BlockTreeWidgetItem::unload(BlockTreeWidgetItem *item)
+{
+    item->_blockDesc = QJsonObject();
+
+    //delete the items from the bottom up until one is still in use
+    while (item->childCount() == 0 and item->_blockDesc.isEmpty())
+    {
+        auto parent = dynamic_cast<BlockTreeWidgetItem *>(item->parent());
+        if (parent == nullptr) return item; //top level, owned by the tree
+        parent->_subNodes.erase(item->text(0));
+        delete item;
+        item = parent;
+    }
+    return nullptr;
+}
+
+bool BlockTreeWidgetItem::operator<(const QTreeWidgetItem &other) const
+{
+    auto otherItem = dynamic_cast<const BlockTreeWidgetItem *>(&other);
+    if (otherItem != nullptr and otherItem->_matchRank != _matchRank)
+    {
+        return _matchRank < otherItem->_matchRank;
+    }
+    return QTreeWidgetItem::operator<(other);
+}
+
 //this sets a tool tip -- but only when requested
 QVariant BlockTreeWidgetItem::data(int column, int role) const
 {
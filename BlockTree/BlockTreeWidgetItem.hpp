@@ -1,4 +1,4 @@
-// Copyright (c) 2014-2017 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #pragma once
@@ -13,18 +13,39 @@ class BlockTreeWidgetItem : public QTreeWidgetItem
 public:
     template <typename ParentType>
     BlockTreeWidgetItem(ParentType *parent, const QString &name):
-        QTreeWidgetItem(parent, QStringList(name))
+        QTreeWidgetItem(parent, QStringList(name)),
+        _matchRank(0)
     {
         return;
     }
 
-    void load(const QJsonObject &blockDesc, const QString &category, const size_t depth = 0);
+    /*!
+     * Load a block description into the category tree under this item.
+     * \return the item that holds the block description
+     */
+    BlockTreeWidgetItem *load(const QJsonObject &blockDesc, const QString &category, const size_t depth = 0);
+
+    /*!
+     * Remove a block item that was returned by load().
+     * Category items that are left empty are removed as well.
+     * \return the top level item when it was left empty, or null
+     */
+    static BlockTreeWidgetItem *unload(BlockTreeWidgetItem *item);
 
     const QJsonObject &getBlockDesc(void) const
     {
         return _blockDesc;
     }
 
+    //! Set the quality of the search match, lower is better
+    void setMatchRank(const int rank)
+    {
+        _matchRank = rank;
+    }
+
+    //! Better search matches sort first, then by name
+    bool operator<(const QTreeWidgetItem &other) const override;
+
 private:
     //this sets a tool tip -- but only when requested
     QVariant data(int column, int role) const;
@@ -35,4 +56,5 @@ private:
 
     std::map<QString, BlockTreeWidgetItem *> _subNodes;
     QJsonObject _blockDesc;
+    int _matchRank;
 };
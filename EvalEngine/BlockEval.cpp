@@ -6,7 +6,11 @@
 #include "GraphObjects/GraphBlock.hpp"
 #include "ThreadPoolEval.hpp"
 #include "EnvironmentEval.hpp"
+#include "BlockInstanceCache.hpp"
+#include "BlockTree/BlockDesc.hpp"
+#include "ConstantGraph.hpp"
 #include "EvalTracer.hpp"
+#include "EvalMetrics.hpp"
 #include <Pothos/Proxy.hpp>
 #include <Pothos/Framework.hpp>
 #include <QJsonDocument>
@@ -16,10 +20,27 @@
 #include <QApplication>
 #include <QRegularExpression>
 #include <QSet>
+#include <algorithm> //min
+#include <atomic>
 
 //! Number of milliseconds until the overlay is considered expired
 static const int OVERLAY_EXPIRED_MS = 5000;
 
+//! Overlays that recently changed are queried again sooner
+static const int OVERLAY_MIN_EXPIRED_MS = 500;
+
+//! The first retry of a block that failed to construct, doubled per failure
+static const int RETRY_MIN_BACKOFF_MS = 1000;
+
+//! The longest wait between retries of a block that failed to construct
+static const int RETRY_MAX_BACKOFF_MS = 60000;
+
+//! Unique numbers for block updates across the worker threads
+static std::atomic<size_t> updateGenerationCounter(0);
+
+//! Error string for blocks that do not implement an overlay
+static const std::string NO_OVERLAY_ERROR_STRING = "call(overlay): method does not exist in registry";
+
 //! helper to convert the port info vector into JSON for serialization of the block
 static QJsonArray portInfosToJSON(const std::vector<Pothos::PortInfo> &infos)
 {
@@ -37,11 +58,51 @@ static QJsonArray portInfosToJSON(const std::vector<Pothos::PortInfo> &infos)
     return array;
 }
 
+/*!
+ * The instance key identifies a constructed block by its path, the
+ * expressions of the critical properties, and the expressions of the
+ * constants that they depend upon -- which determine the evaluated values.
+ */
+static QString getBlockInstanceKey(const BlockInfo &info)
+{
+    QStringList parts(info.desc->getPath());
+    QSet<QString> symbols;
+    for (const auto &propKey : info.desc->getCriticalPropKeys())
+    {
+        auto it = info.properties.find(propKey);
+        const auto expr = (it == info.properties.end())?QString():it->second;
+        parts.push_back(propKey + "=" + expr);
+        symbols += ConstantGraph::tokenize(expr);
+    }
+    if (info.constantGraph)
+    {
+        QStringList names = info.constantGraph->getConstantsUsed(symbols).values();
+        names.sort();
+        for (const auto &name : names)
+        {
+            auto it = info.constants.find(name);
+            if (it != info.constants.end()) parts.push_back(name + ":=" + it->second);
+        }
+    }
+    return parts.join("\n");
+}
+
 BlockEval::BlockEval(void):
+    _requireUpdate(true),
+    _updateGeneration(0),
+    _envFailureState(false),
+    _threadPoolFailureState(false),
+    _constructionFailed(false),
+    _retryPending(false),
+    _retryBackoffMs(RETRY_MIN_BACKOFF_MS),
+    _blockActivated(false),
     _queryPortDesc(false),
+    _hasNoOverlay(false),
+    _overlayIntervalMs(OVERLAY_MIN_EXPIRED_MS),
+    _statusPending(false),
+    _statusPosted(false),
     _logger(Poco::Logger::get("PothosFlow.BlockEval"))
 {
-    qRegisterMetaType<BlockStatus>("BlockStatus");
     this->moveToThread(QApplication::instance()->thread());
 }
 
@@ -53,9 +114,9 @@ BlockEval::~BlockEval(void)
 bool BlockEval::isInfoMatch(const BlockInfo &info) const
 {
     if (info.id != _newBlockInfo.id) return false;
-    if (info.desc.isEmpty()) return false;
-    if (_newBlockInfo.desc.isEmpty()) return false;
-    return info.desc["path"] == _newBlockInfo.desc["path"];
+    if (not info.desc or info.desc->getJSON().isEmpty()) return false;
+    if (not _newBlockInfo.desc or _newBlockInfo.desc->getJSON().isEmpty()) return false;
+    return info.desc->getPath() == _newBlockInfo.desc->getPath();
 }
 
 bool BlockEval::isReady(void) const
@@ -91,6 +152,18 @@ bool BlockEval::shouldDisconnect(void) const
     return false;
 }
 
+bool BlockEval::shouldReconstruct(void) const
+{
+    //there is no block, nothing is torn down
+    if (not _proxyBlock) return false;
+
+    //a disabled block is torn down, but not constructed again
+    if (not _newBlockInfo.enabled) return false;
+
+    //moved eval environments or critical change
+    return (_newEnvironmentEval != _lastEnvironmentEval) or this->hasCriticalChange();
+}
+
 bool BlockEval::portExists(const QString &name, const bool isInput) const
 {
     const auto portDesc = isInput?_lastBlockStatus.inPortDesc:_lastBlockStatus.outPortDesc;
@@ -109,25 +182,60 @@ Pothos::Proxy BlockEval::getProxyBlock(void) const
     return _proxyBlock;
 }
 
+void BlockEval::setConnectionErrors(const QStringList &errorMsgs)
+{
+    if (errorMsgs == _lastBlockStatus.connectionErrorMsgs) return;
+    _lastBlockStatus.connectionErrorMsgs = errorMsgs;
+    this->markStatusPending();
+}
+
 void BlockEval::acceptInfo(const BlockInfo &info)
 {
+    if (info == _newBlockInfo) return;
+    _requireUpdate = true;
+    _retryBackoffMs = RETRY_MIN_BACKOFF_MS; //new inputs deserve a prompt retry
     _newBlockInfo = info;
     _lastBlockStatus.block = _newBlockInfo.block;
+    this->updateConstantsUsed();
 }
 
 void BlockEval::acceptEnvironment(const std::shared_ptr<EnvironmentEval> &env)
 {
+    if (env != _newEnvironmentEval) _requireUpdate = true;
     _newEnvironmentEval = env;
 }
 
 void BlockEval::acceptThreadPool(const std::shared_ptr<ThreadPoolEval> &tp)
 {
+    if (tp != _newThreadPoolEval) _requireUpdate = true;
     _newThreadPoolEval = tp;
 }
 
+bool BlockEval::isUpdateRequired(void) const
+{
+    if (_requireUpdate) return true;
+
+    //the last construction failed, retry once the backoff elapsed
+    if (_retryPending and std::chrono::steady_clock::now() >= _retryTime) return true;
+
+    //the environment was replaced or changed state
+    if (_newEnvironmentEval->getEnv() != _newEnvironment) return true;
+    if (_newEnvironmentEval->isFailureState() != _envFailureState) return true;
+
+    //the thread pool was replaced or changed state
+    if (not (_newThreadPoolEval->getThreadPool() == _newThreadPool)) return true;
+    if (_newThreadPoolEval->isFailureState() != _threadPoolFailureState) return true;
+
+    return false;
+}
+
 void BlockEval::update(void)
 {
     EVAL_TRACER_FUNC_ARG(_newBlockInfo.id);
+    _requireUpdate = false;
+    _updateGeneration = ++updateGenerationCounter;
+    _constructionFailed = false;
+    _retryPending = false;
     _newEnvironment = _newEnvironmentEval->getEnv();
     _newThreadPool = _newThreadPoolEval->getThreadPool();
 
@@ -135,12 +243,29 @@ void BlockEval::update(void)
     _lastBlockStatus.blockErrorMsgs.clear();
     _lastBlockStatus.propertyErrorMsgs.clear();
 
-    //perform evaluation
+    //perform evaluation, a graph widget under construction
+    //in the gui thread is completed later by finishUpdate()
     const bool evalSuccess = this->evaluationProcedure();
+    if (this->isUpdatePending()) return;
+    this->postUpdate(evalSuccess);
+}
+
+void BlockEval::finishUpdate(void)
+{
+    if (not this->isUpdatePending()) return;
+    EVAL_TRACER_FUNC_ARG(_newBlockInfo.id);
 
-    //When eval fails, do a re-check on the environment.
+    //wait on the gui thread, then complete the evaluation procedure
+    const bool evalSuccess = _guiEvalResult.get();
+    this->postUpdate(this->completionProcedure(evalSuccess));
+}
+
+void BlockEval::postUpdate(const bool evalSuccess)
+{
+    //When the block could not be made, do a re-check on the environment.
     //Because block eval could have killed the environment.
-    if (not evalSuccess) _newEnvironmentEval->update();
+    //Property errors are left to the heartbeat, they do not crash servers.
+    if (_constructionFailed) _newEnvironmentEval->probe();
 
     //When environment fails, replace the block error messages
     //with the error message from the evaluation environment.
@@ -154,8 +279,23 @@ void BlockEval::update(void)
     //we should have at least one error reported when not success
     assert(evalSuccess or not _lastBlockStatus.blockErrorMsgs.empty());
 
-    //post the most recent status into the block in the gui thread context
-    QMetaObject::invokeMethod(this, "postStatusToBlock", Qt::QueuedConnection, Q_ARG(BlockStatus, _lastBlockStatus));
+    //a block that could not be made may be waiting on a resource like a device,
+    //retry with a backoff, but errors in the block's own inputs are not retried,
+    //and an environment in failure state triggers an update when it recovers
+    if (evalSuccess) _retryBackoffMs = RETRY_MIN_BACKOFF_MS;
+    else if (_constructionFailed and not _newEnvironmentEval->isFailureState())
+    {
+        _retryPending = true;
+        _retryTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(_retryBackoffMs);
+        _retryBackoffMs = std::min(_retryBackoffMs*2, RETRY_MAX_BACKOFF_MS);
+    }
+
+    //record the observed states for change detection on the next pass
+    _envFailureState = _newEnvironmentEval->isFailureState();
+    _threadPoolFailureState = _newThreadPoolEval->isFailureState();
+
+    //the most recent status is posted into the block with the batch of this pass
+    this->markStatusPending();
 }
 
 /***********************************************************************
@@ -170,6 +310,15 @@ bool BlockEval::evaluationProcedure(void)
         _lastBlockStatus.blockErrorMsgs.push_back(_newEnvironmentEval->getErrorMsg());
         return false;
     }
+
+    //the placeholder description of a block loaded before the
+    //block cache is missing the mode, arguments, and calls
+    if (_newBlockInfo.descPending)
+    {
+        _lastBlockStatus.blockErrorMsgs.push_back(tr("Waiting for the block description of %1")
+            .arg(_newBlockInfo.desc->getPath()));
+        return false;
+    }
     bool evalSuccess = true;
 
     //the environment changed? clear everything
@@ -177,11 +326,11 @@ bool BlockEval::evaluationProcedure(void)
     if (_newEnvironment != _lastEnvironment or
         _newBlockInfo.enabled != _lastBlockInfo.enabled)
     {
+        this->releaseBlockInstance(); //not cached, release resources like device handles
         _lastEnvironmentEval = _newEnvironmentEval;
         _lastEnvironment = _newEnvironment;
         _lastBlockInfo = BlockInfo();
-        _blockEval = Pothos::Proxy();
-        _proxyBlock = Pothos::Proxy();
+        this->updateConstantsUsed();
     }
 
     //when disabled, we only evaluate the properties
@@ -189,7 +338,6 @@ bool BlockEval::evaluationProcedure(void)
     if (not _newBlockInfo.enabled)
     {
         evalSuccess = this->updateAllProperties();
-        goto handle_property_errors;
     }
 
     //special case: apply settings only
@@ -202,7 +350,7 @@ bool BlockEval::evaluationProcedure(void)
         {
             try
             {
-                EVAL_TRACER_ACTION("call " + setter);
+                EVAL_TRACER_ACTION_ARG("call", setter);
                 _blockEval.call("handleCall", setter.toStdString());
             }
             catch (const Pothos::Exception &ex)
@@ -218,32 +366,106 @@ bool BlockEval::evaluationProcedure(void)
     //otherwise, make a new block and all calls
     //update all properties - regardless of changes
     //this may create a new _blockEval if needed
-    else if (this->updateAllProperties())
+    else
     {
-        _proxyBlock = Pothos::Proxy(); //drop old handle
+        //port info must be required after re-eval
+        _queryPortDesc = true;
+
+        //the new block may implement an overlay
+        _hasNoOverlay = false;
+        _overlayIntervalMs = OVERLAY_MIN_EXPIRED_MS;
+
+        //keep the dropped block for reuse, and reuse a cached block when available
+        this->cacheBlockInstance();
+        const auto cachedBlock = this->takeCachedBlockInstance();
+
+        if (not this->updateAllProperties()) evalSuccess = false;
+
+        //the cached block is configured for its previous use, call all setters
+        else if (cachedBlock)
+        {
+            EVAL_TRACER_ACTION_ARG("reuse", _newBlockInfo.id);
+            _proxyBlock = cachedBlock;
+            for (const auto &call : _newBlockInfo.desc->getSetters())
+            {
+                const auto &setter = call.name;
+                try
+                {
+                    _blockEval.call("handleCall", setter.toStdString());
+                }
+                catch (const Pothos::Exception &ex)
+                {
+                    this->reportError(setter, ex);
+                    evalSuccess = false;
+                    break;
+                }
+            }
+            if (evalSuccess) try
+            {
+                _proxyBlock.call("setName", _newBlockInfo.id.toStdString());
+            }
+            catch (const Pothos::Exception &ex)
+            {
+                this->reportError("setName", ex);
+                evalSuccess = false;
+            }
+        }
 
         //widget blocks have to be evaluated in the GUI thread context, otherwise, eval here
-        if (_newBlockInfo.isGraphWidget)
+        //the construction is queued without waiting so other blocks continue to evaluate,
+        //and the rest of the procedure runs in completionProcedure() from finishUpdate()
+        else if (_newBlockInfo.isGraphWidget)
         {
+            _proxyBlock = Pothos::Proxy(); //drop old handle
             EVAL_TRACER_ACTION("blockEvalInGUIContext");
-            QMetaObject::invokeMethod(this, "blockEvalInGUIContext", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, evalSuccess));
+            _guiEvalPromise = std::promise<bool>();
+            _guiEvalResult = _guiEvalPromise.get_future();
+            QMetaObject::invokeMethod(this, "blockEvalInGUIContextAsync", Qt::QueuedConnection);
+            return true;
         }
         else try
         {
-            EVAL_TRACER_ACTION("eval " + _newBlockInfo.id);
-            _blockEval.call("eval", _newBlockInfo.id.toStdString());
+            EVAL_TRACER_ACTION_ARG("eval", _newBlockInfo.id);
+            try
+            {
+                _blockEval.call("eval", _newBlockInfo.id.toStdString());
+            }
+            catch (const Pothos::Exception &)
+            {
+                //cached blocks may hold resources like device handles,
+                //release the cached blocks of this path and try again
+                const auto &path = _newBlockInfo.desc->getPath();
+                if (_newEnvironmentEval->getBlockInstanceCache().evict(path) == 0) throw;
+                _blockEval.call("eval", _newBlockInfo.id.toStdString());
+            }
             _proxyBlock = _blockEval.call("getProxyBlock");
         }
         catch(const Pothos::Exception &ex)
         {
             this->reportError("eval", ex);
+            _constructionFailed = true;
             evalSuccess = false;
         }
 
-        //port info must be required after re-eval
-        _queryPortDesc = true;
+        //remember the arguments that the block was constructed with,
+        //the last block info may be stale when a later evaluation failed
+        if (_proxyBlock)
+        {
+            _blockInstancePath = _newBlockInfo.desc->getPath();
+            _blockInstanceKey = getBlockInstanceKey(_newBlockInfo);
+            _blockActivated = false;
+        }
     }
-    else evalSuccess = false;
+
+    return this->completionProcedure(evalSuccess);
+}
+
+bool BlockEval::completionProcedure(bool evalSuccess)
+{
+    EVAL_TRACER_FUNC();
+
+    //when disabled, there is no block to validate
+    if (not _newBlockInfo.enabled) goto handle_property_errors;
 
     //validate the id
     if (_newBlockInfo.id.isEmpty())
@@ -258,53 +480,7 @@ bool BlockEval::evaluationProcedure(void)
 
     //query description overlay, even if in error
     //the overlay could be valuable even when a setup call fails
-    if (std::chrono::high_resolution_clock::now() > _lastBlockStatus.overlayExpired or _queryPortDesc)
-    {
-        auto proxyBlock = this->getProxyBlock();
-        if (proxyBlock) try
-        {
-            EVAL_TRACER_ACTION("get overlay");
-            const std::string overlayStr = proxyBlock.call("overlay");
-            const QByteArray overlayBytes(overlayStr.data(), overlayStr.size());
-            if (overlayBytes != _lastBlockStatus.overlayDescStr)
-            {
-                QJsonParseError errorParser;
-                const auto jsonDoc = QJsonDocument::fromJson(overlayBytes, &errorParser);
-                if (jsonDoc.isNull())
-                {
-                    _logger.warning("Failed to parse JSON description overlay from %s: %s",
-                        _newBlockInfo.id.toStdString(), errorParser.errorString().toStdString());
-                }
-                else
-                {
-                    _lastBlockStatus.overlayDesc = jsonDoc.object();
-                    _lastBlockStatus.overlayDescStr = overlayBytes;
-                }
-            }
-        }
-        catch(const Pothos::ProxyExceptionMessage &ex)
-        {
-            // If overlay() throws an exception, log the exception's message. We need to specifically
-            // check for the error string corresponding to the call not existing to avoid logging the
-            // error caught when PothosFlow attempts to call a nonexistent function.
-            static const std::string noOverlayErrorString = "call(overlay): method does not exist in registry";
-            if(std::string::npos == ex.message().find(noOverlayErrorString))
-            {
-                poco_error_f2(
-                    _logger,
-                    "%s:overlay() threw the following exception: %s",
-                    proxyBlock.call<std::string>("getName"),
-                    ex.message());
-            }
-        }
-        catch (...)
-        {
-            //the function may not exist, ignore error
-        }
-
-        //no matter what happens, mark the time so we don't over query the overlay
-        _lastBlockStatus.overlayExpired = std::chrono::high_resolution_clock::now() + std::chrono::milliseconds(OVERLAY_EXPIRED_MS);
-    }
+    if (this->isOverlayExpired() or (_queryPortDesc and not _hasNoOverlay)) this->queryOverlay();
 
     //load its port info
     if (evalSuccess and _queryPortDesc) try
@@ -365,50 +541,294 @@ bool BlockEval::evaluationProcedure(void)
     }
 
     //stash the most recent state
-    if (evalSuccess) _lastBlockInfo = _newBlockInfo;
+    if (evalSuccess)
+    {
+        _lastBlockInfo = _newBlockInfo;
+        this->updateConstantsUsed();
+    }
 
     return evalSuccess;
 }
 
+/***********************************************************************
+ * description overlay implementation
+ **********************************************************************/
+bool BlockEval::isOverlayExpired(void) const
+{
+    if (_hasNoOverlay) return false;
+    return std::chrono::high_resolution_clock::now() > _lastBlockStatus.overlayExpired;
+}
+
+void BlockEval::updateOverlays(
+    const std::shared_ptr<EnvironmentEval> &envEval,
+    const std::vector<std::shared_ptr<BlockEval>> &blockEvals)
+{
+    //gather the blocks with an expired overlay,
+    //graph widgets live in the gui and are queried one at a time
+    std::vector<std::shared_ptr<BlockEval>> expired, singles;
+    Pothos::ProxyVector proxyBlocks;
+    for (const auto &blockEval : blockEvals)
+    {
+        if (not blockEval->isOverlayExpired()) continue;
+        auto proxyBlock = blockEval->getProxyBlock();
+        if (not proxyBlock) continue;
+        if (blockEval->isGraphWidget()) singles.push_back(blockEval);
+        else
+        {
+            expired.push_back(blockEval);
+            proxyBlocks.push_back(proxyBlock);
+        }
+    }
+
+    //query all overlays in a single request to the environment when supported
+    static const std::string callName("queryOverlays");
+    QJsonArray results;
+    bool batchOk = false;
+    const auto eval = envEval->getEval();
+    if (expired.size() > 1 and eval and not envEval->isCallUnsupported(callName)) try
+    {
+        EVAL_TRACER_ACTION_ARG("queryOverlays", QString::number(expired.size()));
+        const std::string replyStr = eval.call(callName, proxyBlocks);
+        QJsonParseError errorParser;
+        const auto jsonDoc = QJsonDocument::fromJson(QByteArray(replyStr.data(), replyStr.size()), &errorParser);
+        if (jsonDoc.isNull()) throw Pothos::Exception(errorParser.errorString().toStdString());
+        results = jsonDoc.array();
+        if (size_t(results.size()) != expired.size()) throw Pothos::Exception("result size mismatch");
+        batchOk = true;
+    }
+    catch (const Pothos::Exception &ex)
+    {
+        //the evaluator does not implement the batched call,
+        //remember for the environment so the call is only probed once,
+        //otherwise the failure may be transient: query one at a time this pass
+        if (EnvironmentEval::isMissingCallError(ex.message())) envEval->setCallUnsupported(callName);
+        else Poco::Logger::get("PothosFlow.BlockEval").debug("batched queryOverlays failed - %s", ex.message());
+    }
+
+    for (size_t i = 0; i < expired.size(); i++)
+    {
+        auto &blockEval = expired[i];
+        const bool changed = batchOk?
+            blockEval->applyOverlayResult(results.at(int(i))):
+            blockEval->queryOverlay();
+
+        //post the overlay change into the block with the batch of this pass
+        if (changed) blockEval->markStatusPending();
+    }
+    for (const auto &blockEval : singles)
+    {
+        if (blockEval->queryOverlay()) blockEval->markStatusPending();
+    }
+}
+
+bool BlockEval::queryOverlay(void)
+{
+    auto proxyBlock = this->getProxyBlock();
+    if (not proxyBlock) return this->applyOverlayResult(QJsonValue(QJsonValue::Undefined));
+    try
+    {
+        EVAL_TRACER_ACTION("get overlay");
+        const std::string overlayStr = proxyBlock.call("overlay");
+        return this->applyOverlayResult(QString::fromStdString(overlayStr));
+    }
+    catch(const Pothos::ProxyExceptionMessage &ex)
+    {
+        //the block does not implement an overlay, never query again
+        if (std::string::npos != ex.message().find(NO_OVERLAY_ERROR_STRING))
+        {
+            return this->applyOverlayResult(QJsonValue::Null);
+        }
+
+        QJsonObject error;
+        error["error"] = QString::fromStdString(ex.message());
+        return this->applyOverlayResult(error);
+    }
+    catch (...)
+    {
+        //the function may not exist, ignore error
+        return this->applyOverlayResult(QJsonValue(QJsonValue::Undefined));
+    }
+}
+
+bool BlockEval::applyOverlayResult(const QJsonValue &result)
+{
+    const auto lastOverlayDescStr = _lastBlockStatus.overlayDescStr;
+
+    //a string result contains the JSON overlay description
+    if (result.isString())
+    {
+        const auto overlayBytes = result.toString().toUtf8();
+        if (overlayBytes != _lastBlockStatus.overlayDescStr)
+        {
+            QJsonParseError errorParser;
+            const auto jsonDoc = QJsonDocument::fromJson(overlayBytes, &errorParser);
+            if (jsonDoc.isNull())
+            {
+                _logger.warning("Failed to parse JSON description overlay from %s: %s",
+                    _newBlockInfo.id.toStdString(), errorParser.errorString().toStdString());
+            }
+            else
+            {
+                _lastBlockStatus.overlayDesc = jsonDoc.object();
+                _lastBlockStatus.overlayDescStr = overlayBytes;
+            }
+        }
+    }
+
+    //a null result means that the block has no overlay method
+    else if (result.isNull())
+    {
+        _hasNoOverlay = true;
+    }
+
+    //an error object means that the overlay method threw
+    else if (result.isObject())
+    {
+        _logger.error("%s:overlay() threw the following exception: %s",
+            _newBlockInfo.id.toStdString(), result.toObject()["error"].toString().toStdString());
+    }
+
+    //recently changed overlays are queried again sooner,
+    //and the interval backs off while the overlay is stable
+    const bool changed = lastOverlayDescStr != _lastBlockStatus.overlayDescStr;
+    if (changed) _overlayIntervalMs = OVERLAY_MIN_EXPIRED_MS;
+    else _overlayIntervalMs = std::min(_overlayIntervalMs*2, OVERLAY_EXPIRED_MS);
+
+    //no matter what happens, mark the time so we don't over query the overlay
+    _lastBlockStatus.overlayExpired = std::chrono::high_resolution_clock::now() + std::chrono::milliseconds(_overlayIntervalMs);
+    return changed;
+}
+
+/***********************************************************************
+ * block info comparison for change detection
+ **********************************************************************/
+bool operator==(const BlockInfo &lhs, const BlockInfo &rhs)
+{
+    return
+        (lhs.block.data() == rhs.block.data()) and
+        (lhs.isGraphWidget == rhs.isGraphWidget) and
+        (lhs.descPending == rhs.descPending) and
+        (lhs.id == rhs.id) and
+        (lhs.uid == rhs.uid) and
+        (lhs.enabled == rhs.enabled) and
+        (lhs.zone == rhs.zone) and
+        (lhs.properties == rhs.properties) and
+        (lhs.constantNames == rhs.constantNames) and
+        (lhs.constants == rhs.constants) and
+        (lhs.paramDescs == rhs.paramDescs) and
+        (lhs.desc == rhs.desc);
+}
+
 /***********************************************************************
  * update graph block with the latest status
  **********************************************************************/
-void BlockEval::postStatusToBlock(const BlockStatus &status)
+void BlockEval::markStatusPending(void)
 {
-    auto &block = status.block;
-    if (not block) return; //block no longer exists
+    //the delivery delay is measured from the first change
+    if (not _statusPending) _lastBlockStatus.postTime = std::chrono::steady_clock::now();
+    _statusPending = true;
+}
+
+static bool isPortDescEqual(const Poco::Optional<QJsonArray> &lhs, const Poco::Optional<QJsonArray> &rhs)
+{
+    if (lhs.isSpecified() != rhs.isSpecified()) return false;
+    return not lhs.isSpecified() or lhs.value() == rhs.value();
+}
+
+bool BlockEval::takeStatusUpdate(BlockStatusUpdate &update)
+{
+    if (not _statusPending) return false;
+    _statusPending = false;
 
-    //clear old error messages
-    block->clearBlockErrorMsgs();
-    for (const auto &propKey : block->getProperties())
+    const auto &last = _lastBlockStatus;
+    const auto &posted = _postedBlockStatus;
+    int changes = 0;
+
+    //a new block eval or graph block gets the complete status
+    if (not _statusPosted or last.block != posted.block) changes = BlockStatusUpdate::ALL_FIELDS;
+    else
     {
-        block->setPropertyErrorMsg(propKey, "");
+        if (last.propertyTypeInfos != posted.propertyTypeInfos) changes |= BlockStatusUpdate::TYPE_INFOS;
+        if (last.propertyErrorMsgs != posted.propertyErrorMsgs or
+            last.blockErrorMsgs != posted.blockErrorMsgs or
+            last.connectionErrorMsgs != posted.connectionErrorMsgs) changes |= BlockStatusUpdate::ERROR_MSGS;
+        if (not isPortDescEqual(last.inPortDesc, posted.inPortDesc)) changes |= BlockStatusUpdate::IN_PORT_DESC;
+        if (not isPortDescEqual(last.outPortDesc, posted.outPortDesc)) changes |= BlockStatusUpdate::OUT_PORT_DESC;
+        if (last.widget != posted.widget) changes |= BlockStatusUpdate::WIDGET;
+        if (last.overlayDescStr != posted.overlayDescStr) changes |= BlockStatusUpdate::OVERLAY;
     }
 
-    for (const auto &pair : status.propertyTypeInfos)
+    //copy only the changed fields into the update
+    update.changes = changes;
+    update.status = BlockStatus();
+    update.status.block = last.block;
+    update.status.postTime = last.postTime;
+    if (changes & BlockStatusUpdate::TYPE_INFOS) update.status.propertyTypeInfos = last.propertyTypeInfos;
+    if (changes & BlockStatusUpdate::ERROR_MSGS)
     {
-        block->setPropertyTypeStr(pair.first, pair.second);
+        update.status.propertyErrorMsgs = last.propertyErrorMsgs;
+        update.status.blockErrorMsgs = last.blockErrorMsgs;
+        update.status.connectionErrorMsgs = last.connectionErrorMsgs;
     }
-    for (const auto &pair : status.propertyErrorMsgs)
+    if (changes & BlockStatusUpdate::IN_PORT_DESC) update.status.inPortDesc = last.inPortDesc;
+    if (changes & BlockStatusUpdate::OUT_PORT_DESC) update.status.outPortDesc = last.outPortDesc;
+    if (changes & BlockStatusUpdate::WIDGET) update.status.widget = last.widget;
+    if (changes & BlockStatusUpdate::OVERLAY) update.status.overlayDesc = last.overlayDesc;
+
+    _postedBlockStatus = _lastBlockStatus;
+    _statusPosted = true;
+    return true;
+}
+
+void BlockEval::postStatusToBlock(const BlockStatusUpdate &update)
+{
+    const auto &status = update.status;
+    EvalMetrics::global().record("post status delay", std::chrono::steady_clock::now() - status.postTime);
+
+    auto &block = status.block;
+    if (not block) return; //block no longer exists
+
+    if (update.changes & BlockStatusUpdate::TYPE_INFOS)
     {
-        block->setPropertyErrorMsg(pair.first, pair.second);
+        for (const auto &pair : status.propertyTypeInfos)
+        {
+            block->setPropertyTypeStr(pair.first, pair.second);
+        }
     }
-    for (const auto &errMsg : status.blockErrorMsgs)
+    if (update.changes & BlockStatusUpdate::ERROR_MSGS)
     {
-        block->addBlockErrorMsg(errMsg);
+        //clear old error messages
+        block->clearBlockErrorMsgs();
+        for (const auto &propKey : block->getProperties())
+        {
+            block->setPropertyErrorMsg(propKey, "");
+        }
+
+        for (const auto &pair : status.propertyErrorMsgs)
+        {
+            block->setPropertyErrorMsg(pair.first, pair.second);
+        }
+        for (const auto &errMsg : status.blockErrorMsgs)
+        {
+            block->addBlockErrorMsg(errMsg);
+        }
+        for (const auto &errMsg : status.connectionErrorMsgs)
+        {
+            block->addBlockErrorMsg(errMsg);
+        }
     }
-    if (status.inPortDesc.isSpecified())
+    if ((update.changes & BlockStatusUpdate::IN_PORT_DESC) and status.inPortDesc.isSpecified())
     {
         block->setInputPortDesc(status.inPortDesc.value());
     }
-    if (status.outPortDesc.isSpecified())
+    if ((update.changes & BlockStatusUpdate::OUT_PORT_DESC) and status.outPortDesc.isSpecified())
     {
         block->setOutputPortDesc(status.outPortDesc.value());
     }
-    block->setGraphWidget(status.widget);
-    block->setOverlayDesc(status.overlayDesc);
+    if (update.changes & BlockStatusUpdate::WIDGET) block->setGraphWidget(status.widget);
+    if (update.changes & BlockStatusUpdate::OVERLAY) block->setOverlayDesc(status.overlayDesc);
 
-    block->update(); //cause redraw after changes
+    if (update.changes != 0) block->update(); //cause redraw after changes
     emit block->evalDoneEvent(); //trigger done event subscribers
 }
 
@@ -417,42 +837,76 @@ void BlockEval::postStatusToBlock(const BlockStatus &status)
  **********************************************************************/
 bool BlockEval::hasCriticalChange(void) const
 {
-    const auto &blockDesc = _newBlockInfo.desc;
+    for (const auto &propKey : _newBlockInfo.desc->getCriticalPropKeys())
+    {
+        if (didPropKeyHaveChange(propKey)) return true;
+    }
+    return false;
+}
 
-    for (const auto &arg : blockDesc["args"].toArray())
+void BlockEval::cacheBlockInstance(void)
+{
+    //graph widgets are owned by the gui and are never cached
+    if (_newBlockInfo.isGraphWidget) return;
+    if (not _blockEval or not _proxyBlock) return;
+    if (_blockInstanceKey.isEmpty()) return;
+
+    //a block that ran in a topology carries runtime state,
+    //such as buffered samples or an opened stream, do not reuse it
+    if (_blockActivated)
     {
-        const auto propKey = arg.toString();
-        if (propKey == "remoteEnv") {}
-        else if (didPropKeyHaveChange(propKey)) return true;
+        this->releaseBlockInstance();
+        return;
     }
-    for (const auto &callVal : blockDesc["calls"].toArray())
+
+    //only cache into the environment that made the block
+    if (_lastEnvironmentEval and _lastEnvironmentEval->getEnv() == _lastEnvironment)
     {
-        const auto callObj = callVal.toObject();
-        if (callObj["type"].toString() != "initializer") continue;
-        for (const auto &arg : callObj["args"].toArray())
-        {
-            const auto propKey = arg.toString();
-            if (didPropKeyHaveChange(propKey)) return true;
-        }
+        BlockInstance instance;
+        instance.blockEval = _blockEval;
+        instance.proxyBlock = _proxyBlock;
+        _lastEnvironmentEval->getBlockInstanceCache().insert(
+            _blockInstancePath, _blockInstanceKey, instance);
     }
-    return false;
+
+    //the cached block evaluator is not modified again
+    this->releaseBlockInstance();
 }
 
-QStringList BlockEval::settersChangedList(void) const
+void BlockEval::releaseBlockInstance(void)
+{
+    _blockEval = Pothos::Proxy();
+    _proxyBlock = Pothos::Proxy();
+    _blockInstancePath.clear();
+    _blockInstanceKey.clear();
+    _blockActivated = false;
+}
+
+Pothos::Proxy BlockEval::takeCachedBlockInstance(void)
 {
-    const auto &blockDesc = _newBlockInfo.desc;
+    if (_newBlockInfo.isGraphWidget) return Pothos::Proxy();
+
+    BlockInstance instance;
+    auto &blockCache = _newEnvironmentEval->getBlockInstanceCache();
+    if (not blockCache.take(getBlockInstanceKey(_newBlockInfo), instance)) return Pothos::Proxy();
+
+    //the cached block needs its thread pool set again
+    _blockEval = instance.blockEval;
+    _lastThreadPoolEval.reset();
+    _lastThreadPool = Pothos::Proxy();
+    return instance.proxyBlock;
+}
 
+QStringList BlockEval::settersChangedList(void) const
+{
     QStringList changedList;
-    for (const auto &callVal : blockDesc["calls"].toArray())
+    for (const auto &call : _newBlockInfo.desc->getSetters())
     {
-        const auto callObj = callVal.toObject();
-        if (callObj["type"].toString() != "setter") continue;
-        for (const auto &arg : callObj["args"].toArray())
+        for (const auto &propKey : call.args)
         {
-            const auto propKey = arg.toString();
             if (didPropKeyHaveChange(propKey))
             {
-                changedList.push_back(callObj["name"].toString());
+                changedList.push_back(call.name);
             }
         }
     }
@@ -466,68 +920,62 @@ bool BlockEval::didPropKeyHaveChange(const QString &key) const
     const auto newVal = _newBlockInfo.properties.at(key);
     const auto oldVal = _lastBlockInfo.properties.at(key);
     if (newVal != oldVal) return true;
-    return (this->didExprHaveChange(newVal));
-}
-
-bool BlockEval::didExprHaveChange(const QString &expr) const
-{
-    for (const auto &name : this->getConstantsUsed(expr))
-    {
-        const bool foundInNew = _newBlockInfo.constants.count(name) != 0;
-        const bool foundInLast = _lastBlockInfo.constants.count(name) != 0;
-
-        //token is not a constant -- ignore
-        if (not foundInNew and not foundInLast) continue;
-
-        //constant removal detection -- report as changed
-        if (foundInNew and not foundInLast) return true;
-        if (not foundInNew and foundInLast) return true;
-
-        //constant expression changed
-        if (_newBlockInfo.constants.at(name) != _lastBlockInfo.constants.at(name)) return true;
-    }
-
-    return false;
+    auto it = _propertyConstants.find(key);
+    if (it == _propertyConstants.end()) return true;
+    return it->second.intersects(_changedConstants);
 }
 
 bool BlockEval::isConstantUsed(const QString &name) const
 {
-    QStringList used;
-    for (const auto &pair : _newBlockInfo.properties)
-    {
-        const auto &propVal = pair.second;
-        used += this->getConstantsUsed(propVal);
-    }
-    return used.contains(name);
+    return _usedConstants.contains(name);
 }
 
-QStringList BlockEval::getConstantsUsed(const QString &expr, const size_t depth) const
+void BlockEval::updateConstantsUsed(void)
 {
-    //probably encountered a loop, declare this a change
-    if (depth > _newBlockInfo.constants.size()) return QStringList();
+    const auto &newGraph = _newBlockInfo.constantGraph;
+    const auto &lastGraph = _lastBlockInfo.constantGraph;
 
-    //create a recursive list of used constants by traversing expressions
-    QStringList used;
-    #if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
-        #define behavior QString::SkipEmptyParts
-    #else
-        #define behavior Qt::SkipEmptyParts //old flags deprecated in 5.14
-    #endif
-    for (const auto &tok : expr.split(QRegularExpression("\\W"), behavior))
+    //determine the constants added, removed, or changed since the last eval
+    //the same shared graph means that the constant expressions are identical
+    _changedConstants.clear();
+    if (not newGraph or newGraph != lastGraph)
     {
-        //is this token a constant? then inspect it
-        if (_newBlockInfo.constants.count(tok) != 0)
+        for (const auto &pair : _newBlockInfo.constants)
         {
-            used.push_back(tok);
-            used += this->getConstantsUsed(_newBlockInfo.constants.at(tok), depth+1);
+            auto it = _lastBlockInfo.constants.find(pair.first);
+            if (it == _lastBlockInfo.constants.end() or it->second != pair.second)
+            {
+                _changedConstants.insert(pair.first);
+            }
         }
-        if (_lastBlockInfo.constants.count(tok) != 0)
+        for (const auto &pair : _lastBlockInfo.constants)
         {
-            used.push_back(tok);
-            used += this->getConstantsUsed(_lastBlockInfo.constants.at(tok), depth+1);
+            if (_newBlockInfo.constants.count(pair.first) == 0)
+            {
+                _changedConstants.insert(pair.first);
+            }
         }
     }
-    return used;
+
+    //determine the constants used by each property expression,
+    //the symbols are only re-tokenized when the expression changes
+    std::map<QString, QSet<QString>> exprSymbols;
+    _propertyConstants.clear();
+    _usedConstants.clear();
+    for (const auto &pair : _newBlockInfo.properties)
+    {
+        const auto &expr = pair.second;
+        auto &symbols = exprSymbols[expr];
+        auto it = _exprSymbols.find(expr);
+        if (it != _exprSymbols.end()) symbols = it->second;
+        else symbols = ConstantGraph::tokenize(expr);
+
+        auto &used = _propertyConstants[pair.first];
+        if (newGraph) used += newGraph->getConstantsUsed(symbols);
+        if (lastGraph and lastGraph != newGraph) used += lastGraph->getConstantsUsed(symbols);
+        _usedConstants += used;
+    }
+    _exprSymbols = exprSymbols;
 }
 
 bool BlockEval::updateAllProperties(void)
@@ -550,15 +998,20 @@ bool BlockEval::updateAllProperties(void)
             evalEnv = _newEnvironmentEval->getEval();
         }
         auto BlockEval = evalEnv.getEnvironment()->findProxy("Pothos/Util/BlockEval");
-        _blockEval = BlockEval(_newBlockInfo.desc["path"].toString().toStdString(), evalEnv);
+        _blockEval = BlockEval(_newBlockInfo.desc->getPath().toStdString(), evalEnv);
         _lastThreadPoolEval.reset();
     }
     catch (const Pothos::Exception &ex)
     {
         this->reportError("make", ex);
+        _constructionFailed = true;
         return false;
     }
 
+    //apply constants and eval properties in a single request when supported
+    bool batchSuccess = false;
+    if (this->evalAllPropertiesBatched(batchSuccess)) return batchSuccess;
+
     //apply constants before eval property expressions
     if (not this->applyConstants()) return false;
 
@@ -568,7 +1021,7 @@ bool BlockEval::updateAllProperties(void)
     {
         const auto &propKey = pair.first;
         const auto &propVal = pair.second;
-        EVAL_TRACER_ACTION("update property " + propKey);
+        EVAL_TRACER_ACTION_ARG("update property", propKey);
         try
         {
             auto obj = _blockEval.call("evalProperty", propKey.toStdString(), propVal.toStdString());
@@ -583,21 +1036,24 @@ bool BlockEval::updateAllProperties(void)
     return not hasError;
 }
 
-bool BlockEval::applyConstants(void)
+QStringList BlockEval::getRemovedConstants(void) const
 {
-    EVAL_TRACER_FUNC();
-
-    //determine which constants were removed from the last eval
     auto removedConstants = _lastBlockInfo.constantNames; //copy
     for (const auto &name : _newBlockInfo.constantNames)
     {
         removedConstants.removeAll(name);
     }
+    return removedConstants;
+}
+
+bool BlockEval::applyConstants(void)
+{
+    EVAL_TRACER_FUNC();
 
     //unregister all constants from the removed list
-    for (const auto &name : removedConstants)
+    for (const auto &name : this->getRemovedConstants())
     {
-        EVAL_TRACER_ACTION("removeConstant " + name);
+        EVAL_TRACER_ACTION_ARG("removeConstant", name);
         _blockEval.call("removeConstant", name.toStdString());
     }
 
@@ -605,7 +1061,7 @@ bool BlockEval::applyConstants(void)
     for (const auto &name : _newBlockInfo.constantNames)
     {
         if (not this->isConstantUsed(name)) continue;
-        EVAL_TRACER_ACTION("applyConstant " + name);
+        EVAL_TRACER_ACTION_ARG("applyConstant", name);
         try
         {
             const auto &expr = _newBlockInfo.constants.at(name);
@@ -620,6 +1076,95 @@ bool BlockEval::applyConstants(void)
     return true;
 }
 
+bool BlockEval::evalAllPropertiesBatched(bool &success)
+{
+    //graph widgets evaluate in a local environment, not the zone's environment
+    if (_newBlockInfo.isGraphWidget) return false;
+    static const std::string callName("evalProperties");
+    if (_newEnvironmentEval->isCallUnsupported(callName)) return false;
+    EVAL_TRACER_FUNC();
+
+    //Create a request with the constant changes and property expressions:
+    //{"removeConstants": [name...], "applyConstants": [[name, expr]...],
+    // "properties": [[key, expr]...]}
+    QJsonArray removeConstants;
+    for (const auto &name : this->getRemovedConstants())
+    {
+        removeConstants.push_back(name);
+    }
+    QJsonArray applyConstants;
+    for (const auto &name : _newBlockInfo.constantNames)
+    {
+        if (not this->isConstantUsed(name)) continue;
+        applyConstants.push_back(QJsonArray{name, _newBlockInfo.constants.at(name)});
+    }
+    QJsonArray properties;
+    for (const auto &pair : _newBlockInfo.properties)
+    {
+        properties.push_back(QJsonArray{pair.first, pair.second});
+    }
+    QJsonObject request;
+    request["removeConstants"] = removeConstants;
+    request["applyConstants"] = applyConstants;
+    request["properties"] = properties;
+
+    //The reply contains the constant error (if any) and the per-property result:
+    //{"constantError": msg, "properties": {key: {"type": str} or {"error": str}}}
+    QJsonObject reply;
+    try
+    {
+        EVAL_TRACER_ACTION("evalProperties");
+        const auto requestBytes = QJsonDocument(request).toJson(QJsonDocument::Compact);
+        const std::string replyStr = _blockEval.call(callName, requestBytes.toStdString());
+        QJsonParseError errorParser;
+        const auto jsonDoc = QJsonDocument::fromJson(QByteArray(replyStr.data(), replyStr.size()), &errorParser);
+        if (jsonDoc.isNull()) throw Pothos::Exception(errorParser.errorString().toStdString());
+        reply = jsonDoc.object();
+    }
+    catch (const Pothos::Exception &ex)
+    {
+        //the remote block evaluator does not implement the batched call,
+        //remember for the environment so the call is only probed once
+        if (EnvironmentEval::isMissingCallError(ex.message()))
+        {
+            _newEnvironmentEval->setCallUnsupported(callName);
+        }
+
+        //otherwise the failure may be transient, use the per-call path this time
+        else _logger.debug("%s: batched evalProperties failed - %s",
+            _newBlockInfo.id.toStdString(), ex.message());
+        return false;
+    }
+
+    //constants failed to apply, no properties were evaluated
+    const auto constantError = reply.value("constantError").toString();
+    if (not constantError.isEmpty())
+    {
+        this->reportError("applyConstants", Pothos::Exception(constantError.toStdString()));
+        success = false;
+        return true;
+    }
+
+    //record the type or the error for each property
+    success = true;
+    const auto results = reply.value("properties").toObject();
+    for (const auto &pair : _newBlockInfo.properties)
+    {
+        const auto &propKey = pair.first;
+        const auto result = results[propKey].toObject();
+        if (result.contains("type"))
+        {
+            _lastBlockStatus.propertyTypeInfos[propKey] = result["type"].toString();
+        }
+        else
+        {
+            _lastBlockStatus.propertyErrorMsgs[propKey] = result["error"].toString(tr("No result for property"));
+            success = false;
+        }
+    }
+    return true;
+}
+
 void BlockEval::reportError(const QString &action, const Pothos::Exception &ex)
 {
     _lastBlockStatus.blockErrorMsgs.push_back(tr("%1::%2(...) - %3")
@@ -628,6 +1173,11 @@ void BlockEval::reportError(const QString &action, const Pothos::Exception &ex)
         .arg(QString::fromStdString(ex.message())));
 }
 
+void BlockEval::blockEvalInGUIContextAsync(void)
+{
+    _guiEvalPromise.set_value(this->blockEvalInGUIContext());
+}
+
 bool BlockEval::blockEvalInGUIContext(void)
 {
     try
@@ -642,6 +1192,7 @@ bool BlockEval::blockEvalInGUIContext(void)
     {
         _logger.error("Failed to eval in GUI context %s-%s", _newBlockInfo.id.toStdString(), ex.displayText());
         _lastBlockStatus.blockErrorMsgs.push_back(tr("Failed to eval in GUI context %1-%2").arg(_newBlockInfo.id).arg(QString::fromStdString(ex.message())));
+        _constructionFailed = true;
         return false;
     }
 }
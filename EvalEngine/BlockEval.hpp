@@ -1,4 +1,4 @@
-// Copyright (c) 2014-2017 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #pragma once
@@ -12,14 +12,19 @@
 #include <QPointer>
 #include <QString>
 #include <QStringList>
+#include <QSet>
 #include <memory>
+#include <vector>
 #include <chrono>
+#include <future>
 #include <Poco/Logger.h>
 #include <Poco/Optional.h>
 
 class EnvironmentEval;
 class ThreadPoolEval;
+class ConstantGraph;
 class GraphBlock;
+class BlockDesc;
 
 /*!
  * Information about a block that is used for background evaluation.
@@ -32,18 +37,23 @@ class GraphBlock;
 struct BlockInfo
 {
     QPointer<GraphBlock> block;
-    bool isGraphWidget;
+    bool isGraphWidget{false};
+    bool descPending{false}; //placeholder description, not evaluated
     QString id;
-    size_t uid;
-    bool enabled;
+    size_t uid{0};
+    bool enabled{false};
     QString zone;
     std::map<QString, QString> properties;
     QStringList constantNames; //preserves order
     std::map<QString, QString> constants;
+    std::shared_ptr<const ConstantGraph> constantGraph; //parsed constants
     std::map<QString, QJsonObject> paramDescs;
-    QJsonObject desc;
+    std::shared_ptr<const BlockDesc> desc; //interned, compared by pointer
 };
 
+//! Compare block infos to detect changes between evaluations
+bool operator==(const BlockInfo &lhs, const BlockInfo &rhs);
+
 //! values to pass back to the gui thread to update the block
 struct BlockStatus
 {
@@ -52,13 +62,40 @@ struct BlockStatus
     std::map<QString, QString> propertyTypeInfos;
     std::map<QString, QString> propertyErrorMsgs;
     QStringList blockErrorMsgs;
+    QStringList connectionErrorMsgs; //set by the topology eval
     Poco::Optional<QJsonArray> inPortDesc;
     Poco::Optional<QJsonArray> outPortDesc;
     QJsonObject overlayDesc;
     QByteArray overlayDescStr;
     std::chrono::high_resolution_clock::time_point overlayExpired;
+    std::chrono::steady_clock::time_point postTime; //for latency metrics
+};
+
+/*!
+ * A change to the block status delivered to the gui thread.
+ * Only the fields flagged in changes are filled in,
+ * the block pointer and post time are always specified.
+ */
+struct BlockStatusUpdate
+{
+    enum Field
+    {
+        TYPE_INFOS = 1 << 0,
+        ERROR_MSGS = 1 << 1, //property and block errors
+        IN_PORT_DESC = 1 << 2,
+        OUT_PORT_DESC = 1 << 3,
+        WIDGET = 1 << 4,
+        OVERLAY = 1 << 5,
+        ALL_FIELDS = (1 << 6) - 1,
+    };
+
+    BlockStatus status;
+    int changes{0};
 };
 
+//! Status updates collected from one evaluation pass
+typedef std::vector<BlockStatusUpdate> BlockStatusUpdates;
+
 class BlockEval : public QObject
 {
     Q_OBJECT
@@ -93,6 +130,12 @@ public:
      */
     bool shouldDisconnect(void) const;
 
+    /*!
+     * This block will be torn down and constructed again this pass.
+     * The replacement may claim the same resources as the old block.
+     */
+    bool shouldReconstruct(void) const;
+
     /*!
      * Check the current evaluated state to see if a port exists.
      * This is used by the topology evaluation logic to check
@@ -105,6 +148,37 @@ public:
      */
     Pothos::Proxy getProxyBlock(void) const;
 
+    //! Get the graph object ID of the block
+    const QString &getBlockId(void) const
+    {
+        return _newBlockInfo.id;
+    }
+
+    /*!
+     * Set the errors of failed topology connections to this block.
+     * The errors are displayed with the block errors,
+     * but they do not stop the other connections of a ready block.
+     */
+    void setConnectionErrors(const QStringList &errorMsgs);
+
+    /*!
+     * Mark the block as connected in an active topology.
+     * An activated block carries runtime state and is not cached for reuse.
+     */
+    void markActivated(void)
+    {
+        _blockActivated = true;
+    }
+
+    /*!
+     * A unique number for the last update of this block.
+     * Used to retry a failed connection once an endpoint was updated again.
+     */
+    size_t getUpdateGeneration(void) const
+    {
+        return _updateGeneration;
+    }
+
     /*!
      * Called under re-eval to apply the latest info.
      * This call should take the info and not process.
@@ -123,17 +197,61 @@ public:
      */
     void acceptThreadPool(const std::shared_ptr<ThreadPoolEval> &tp);
 
+    /*!
+     * Does this block require an update since the last pass?
+     * True when the info, environment, or thread pool changed,
+     * when the environment or thread pool changed state,
+     * or when the retry backoff of a failed construction elapsed.
+     */
+    bool isUpdateRequired(void) const;
+
     /*!
      * Perform update work after changes applied.
      */
     void update(void);
 
-private slots:
+    /*!
+     * Is the update waiting on the gui thread?
+     * Graph widgets are constructed asynchronously in the gui thread,
+     * and the update is completed by a call to finishUpdate().
+     */
+    bool isUpdatePending(void) const
+    {
+        return _guiEvalResult.valid();
+    }
+
+    /*!
+     * Wait for a pending update and complete the evaluation.
+     * Does nothing when the update is not pending.
+     */
+    void finishUpdate(void);
+
+    /*!
+     * Refresh the expired description overlays of blocks in an environment.
+     * Used for blocks that do not require an update.
+     * The overlays are fetched in a single batched request when the
+     * environment's evaluator supports it, probed once per environment,
+     * otherwise one at a time. Blocks without an overlay are never queried again.
+     */
+    static void updateOverlays(
+        const std::shared_ptr<EnvironmentEval> &envEval,
+        const std::vector<std::shared_ptr<BlockEval>> &blockEvals);
+
+    /*!
+     * Take the status changes since the last delivery to the gui.
+     * The first delivery to a graph block carries all fields.
+     * \param [out] update the changed fields of the block status
+     * \return false when there is no status to deliver
+     */
+    bool takeStatusUpdate(BlockStatusUpdate &update);
 
     /*!
      * Update the block from the gui thread context.
+     * Only the changed fields are applied to the block.
      */
-    void postStatusToBlock(const BlockStatus &status);
+    static void postStatusToBlock(const BlockStatusUpdate &update);
+
+private slots:
 
     /*!
      * Call block eval from the gui thread context.
@@ -141,23 +259,37 @@ private slots:
      */
     bool blockEvalInGUIContext(void);
 
+    //! Call block eval from the gui thread context and fulfill the pending result
+    void blockEvalInGUIContextAsync(void);
+
 private:
 
     //! critical change? need to make a new block
     bool hasCriticalChange(void) const;
 
+    /*!
+     * Move the current block into the instance cache of its environment.
+     * Only blocks never activated in a topology are cached.
+     * The block and its evaluator are dropped from this block eval.
+     */
+    void cacheBlockInstance(void);
+
+    //! Drop the current block and its evaluator without caching
+    void releaseBlockInstance(void);
+
+    /*!
+     * Take a cached block that matches the new block info.
+     * The cached evaluator replaces the block evaluator.
+     * \return the cached block or a null proxy when not found
+     */
+    Pothos::Proxy takeCachedBlockInstance(void);
+
     //! any setters that changed so we can re-call them
     QStringList settersChangedList(void) const;
 
     //! detect a change in properties before vs after
     bool didPropKeyHaveChange(const QString &key) const;
 
-    /*!
-     * Detect a change in an expression
-     * accounting for the constants dependency tree.
-     */
-    bool didExprHaveChange(const QString &expr) const;
-
     /*!
      * Is this constant used in any of the properties.
      * Use this logic to skip registering unused constants.
@@ -165,10 +297,11 @@ private:
     bool isConstantUsed(const QString &name) const;
 
     /*!
-     * Determine all constants used by this expression
-     * The depth parameter prevents infinite recursion.
+     * Update the constants used by each property and the
+     * set of constants that changed since the last evaluation.
+     * Called whenever the new or last block info changes.
      */
-    QStringList getConstantsUsed(const QString &expr, const size_t depth = 0) const;
+    void updateConstantsUsed(void);
 
     /*!
      * Create the remote block evaluator if needed.
@@ -185,15 +318,60 @@ private:
      */
     bool applyConstants(void);
 
+    /*!
+     * Apply constants and evaluate all properties in a single
+     * batched request to the remote block evaluator.
+     * Records the same errors and types as the per-call path.
+     * The call is probed once per environment, see isCallUnsupported().
+     * \param [out] success true when all properties evaluated
+     * \return false when the caller should use the per-call path
+     */
+    bool evalAllPropertiesBatched(bool &success);
+
+    //! Get a list of constants removed since the last eval
+    QStringList getRemovedConstants(void) const;
+
+    //! Is it time to query the description overlay again?
+    bool isOverlayExpired(void) const;
+
+    /*!
+     * Query the description overlay from the block.
+     * \return true when the overlay description changed
+     */
+    bool queryOverlay(void);
+
+    /*!
+     * Apply the result of an overlay query:
+     * a JSON string, null when the block has no overlay,
+     * an object with an error message when the call threw,
+     * or undefined when the overlay could not be queried this time.
+     * The batched reply holds one of these values per block.
+     * \return true when the overlay description changed
+     */
+    bool applyOverlayResult(const QJsonValue &result);
+
     /*!
      * The main evaluation procedure for dealing with changes.
      * Return true for success and false for failure.
      */
     bool evaluationProcedure(void);
 
+    /*!
+     * The remainder of the evaluation procedure after the block is created:
+     * Validation, port info, thread pool, and the error report.
+     * Return true for success and false for failure.
+     */
+    bool completionProcedure(bool evalSuccess);
+
+    //! Re-check the environment, record states, and post the status
+    void postUpdate(const bool evalSuccess);
+
     //! Internal helper for error message formatting
     void reportError(const QString &action, const Pothos::Exception &ex);
 
+    //! Flag the status for the next batched delivery to the gui
+    void markStatusPending(void);
+
     //Tracking state for the eval environment:
     //Also stash the actual proxy environment here.
     //The proxy environment provided by eval may change,
@@ -215,13 +393,54 @@ private:
     BlockInfo _newBlockInfo;
     BlockInfo _lastBlockInfo;
 
+    //Tracking state for incremental evaluation:
+    //Flagged when accepted inputs differ from the last update,
+    //and the failure states observed during the last update.
+    bool _requireUpdate;
+    size_t _updateGeneration;
+    bool _envFailureState;
+    bool _threadPoolFailureState;
+
+    //Retry state for a block that could not be made or constructed:
+    //property and setter errors come from the inputs and are not retried.
+    bool _constructionFailed;
+    bool _retryPending;
+    int _retryBackoffMs;
+    std::chrono::steady_clock::time_point _retryTime;
+
+    //Tracking state for constant change detection:
+    //Property expressions are tokenized once into symbol sets,
+    //and changes are detected by intersecting the used constants
+    //of a property with the constants changed since the last eval.
+    std::map<QString, QSet<QString>> _exprSymbols;
+    std::map<QString, QSet<QString>> _propertyConstants;
+    QSet<QString> _usedConstants;
+    QSet<QString> _changedConstants;
+
     //! tracking status in the eval thread context
     BlockStatus _lastBlockStatus;
 
+    //the status last delivered to the gui for change detection
+    BlockStatus _postedBlockStatus;
+    bool _statusPending;
+    bool _statusPosted;
+
     //remote block evaluator
     Pothos::Proxy _blockEval;
     Pothos::Proxy _proxyBlock;
+    QString _blockInstancePath; //path and key of the arguments the block was made with
+    QString _blockInstanceKey;
+    bool _blockActivated; //connected in a topology, not reused from the cache
     bool _queryPortDesc;
 
+    //overlay query state: blocks without an overlay are never queried,
+    //and the query interval adapts to how often the overlay changes
+    bool _hasNoOverlay;
+    int _overlayIntervalMs;
+
+    //pending graph widget construction in the gui thread context
+    std::promise<bool> _guiEvalPromise;
+    std::future<bool> _guiEvalResult;
+
     Poco::Logger &_logger;
 };
@@ -0,0 +1,88 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "BlockInstanceCache.hpp"
+#include <iterator> //prev, next
+
+BlockInstanceCache::BlockInstanceCache(const size_t capacity, const std::chrono::milliseconds &timeToLive):
+    _capacity(capacity),
+    _timeToLive(timeToLive)
+{
+    return;
+}
+
+void BlockInstanceCache::insert(const QString &path, const QString &key, const BlockInstance &instance)
+{
+    if (_capacity == 0) return;
+
+    //release the evicted blocks outside of the lock
+    std::list<Entry> evicted;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Entry entry;
+        entry.path = path;
+        entry.key = key;
+        entry.instance = instance;
+        entry.expires = std::chrono::steady_clock::now() + _timeToLive;
+        _entries.push_front(entry);
+        while (_entries.size() > _capacity)
+        {
+            evicted.splice(evicted.end(), _entries, std::prev(_entries.end()));
+        }
+    }
+}
+
+bool BlockInstanceCache::take(const QString &key, BlockInstance &instance)
+{
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto it = _entries.begin(); it != _entries.end(); it++)
+    {
+        if (it->key != key) continue;
+        if (it->expires < now) continue; //released by the next expire()
+        instance = it->instance;
+        _entries.erase(it);
+        return true;
+    }
+    return false;
+}
+
+size_t BlockInstanceCache::expire(void)
+{
+    const auto now = std::chrono::steady_clock::now();
+    std::list<Entry> evicted;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto it = _entries.begin(); it != _entries.end();)
+        {
+            auto next = std::next(it);
+            if (it->expires < now) evicted.splice(evicted.end(), _entries, it);
+            it = next;
+        }
+    }
+    return evicted.size();
+}
+
+size_t BlockInstanceCache::evict(const QString &path)
+{
+    std::list<Entry> evicted;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto it = _entries.begin(); it != _entries.end();)
+        {
+            auto next = std::next(it);
+            if (it->path == path) evicted.splice(evicted.end(), _entries, it);
+            it = next;
+        }
+    }
+    return evicted.size();
+}
+
+void BlockInstanceCache::clear(void)
+{
+    std::list<Entry> evicted;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        evicted.swap(_entries);
+    }
+}
@@ -0,0 +1,76 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Config.hpp>
+#include <Pothos/Proxy/Proxy.hpp>
+#include <QString>
+#include <chrono>
+#include <mutex>
+#include <list>
+
+//! A remote block and the block evaluator that made it
+struct BlockInstance
+{
+    Pothos::Proxy blockEval;
+    Pothos::Proxy proxyBlock;
+};
+
+/*!
+ * The block instance cache keeps recently dropped blocks of an environment.
+ * A block evaluation that would construct a block with the same path and
+ * constructor arguments takes the cached instance instead, so that toggling
+ * an argument back and forth or undo and redo does not re-create the block.
+ * The cache holds a limited number of blocks, least recently used first out,
+ * and only for a limited time, because cached blocks may hold resources.
+ */
+class BlockInstanceCache
+{
+public:
+
+    BlockInstanceCache(const size_t capacity, const std::chrono::milliseconds &timeToLive);
+
+    /*!
+     * Add a dropped block to the cache.
+     * \param path the block factory path
+     * \param key the block path and constructor arguments
+     * \param instance the remote block and evaluator
+     */
+    void insert(const QString &path, const QString &key, const BlockInstance &instance);
+
+    /*!
+     * Remove and return a block with a matching key.
+     * \return true when a cached block was found
+     */
+    bool take(const QString &key, BlockInstance &instance);
+
+    /*!
+     * Release all cached blocks that outlived the time to live.
+     * \return the number of released blocks
+     */
+    size_t expire(void);
+
+    /*!
+     * Release all cached blocks with the given path.
+     * Used when a block construction failed, because
+     * cached blocks may hold resources like device handles.
+     * \return the number of released blocks
+     */
+    size_t evict(const QString &path);
+
+    //! Release all cached blocks
+    void clear(void);
+
+private:
+    struct Entry
+    {
+        QString path;
+        QString key;
+        BlockInstance instance;
+        std::chrono::steady_clock::time_point expires;
+    };
+    const size_t _capacity;
+    const std::chrono::milliseconds _timeToLive;
+    std::mutex _mutex;
+    std::list<Entry> _entries; //most recent first
+};
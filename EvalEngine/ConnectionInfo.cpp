@@ -0,0 +1,89 @@
+// Copyright (c) 2014-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConnectionInfo.hpp"
+#include <QHash> //qHash
+#include <functional> //std::hash
+#include <iterator> //std::prev
+
+QString ConnectionInfo::toString(void) const
+{
+    return QString("%1[%2]->%3[%4]")
+        .arg(srcBlockUID).arg(srcPort)
+        .arg(dstBlockUID).arg(dstPort);
+}
+
+bool operator==(const ConnectionInfo &lhs, const ConnectionInfo &rhs)
+{
+    return
+        (lhs.srcBlockUID == rhs.srcBlockUID) and
+        (lhs.dstBlockUID == rhs.dstBlockUID) and
+        (lhs.srcPort == rhs.srcPort) and
+        (lhs.dstPort == rhs.dstPort);
+}
+
+static void hashCombine(size_t &seed, const size_t value)
+{
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+size_t ConnectionInfoHash::operator()(const ConnectionInfo &info) const
+{
+    size_t seed = 0;
+    hashCombine(seed, std::hash<size_t>()(info.srcBlockUID));
+    hashCombine(seed, std::hash<size_t>()(info.dstBlockUID));
+    hashCombine(seed, qHash(info.srcPort));
+    hashCombine(seed, qHash(info.dstPort));
+    return seed;
+}
+
+ConnectionInfos::ConnectionInfos(void)
+{
+    return;
+}
+
+ConnectionInfos::ConnectionInfos(const ConnectionInfos &other)
+{
+    *this = other;
+}
+
+ConnectionInfos &ConnectionInfos::operator=(const ConnectionInfos &other)
+{
+    //the index refers to list nodes, so it must be rebuilt
+    if (this == &other) return *this;
+    this->clear();
+    _index.reserve(other.size());
+    for (const auto &info : other) this->insert(info);
+    return *this;
+}
+
+void ConnectionInfos::insert(const ConnectionInfo &info)
+{
+    if (this->contains(info)) return;
+    _infos.push_back(info);
+    _index.emplace(info, std::prev(_infos.cend()));
+}
+
+void ConnectionInfos::remove(const ConnectionInfo &info)
+{
+    auto it = _index.find(info);
+    if (it == _index.end()) return;
+    _infos.erase(it->second);
+    _index.erase(it);
+}
+
+void ConnectionInfos::clear(void)
+{
+    _index.clear();
+    _infos.clear();
+}
+
+ConnectionInfos diffConnectionInfos(const ConnectionInfos &in0, const ConnectionInfos &in1)
+{
+    ConnectionInfos out;
+    for (const auto &elem : in0)
+    {
+        if (not in1.contains(elem)) out.insert(elem);
+    }
+    return out;
+}
@@ -0,0 +1,96 @@
+// Copyright (c) 2014-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Config.hpp>
+#include <QString>
+#include <unordered_map>
+#include <cstddef>
+#include <list>
+
+/*!
+ * Information about a connection between src and dst ports.
+ * This is everything important we need to know about connections,
+ * but extracted so we can access it in a thread-safe manner.
+ */
+struct ConnectionInfo
+{
+    ConnectionInfo(void):
+        srcBlockUID(0),
+        dstBlockUID(0){}
+    size_t srcBlockUID, dstBlockUID;
+    QString srcPort, dstPort;
+    QString toString(void) const;
+};
+
+bool operator==(const ConnectionInfo &lhs, const ConnectionInfo &rhs);
+
+//! Hash function for using connection info as a hash key
+struct ConnectionInfoHash
+{
+    size_t operator()(const ConnectionInfo &info) const;
+};
+
+/*!
+ * Ordered set of unique connection informations.
+ * Iteration follows the order of insertion,
+ * and the hash index makes lookup, insert,
+ * and removal constant time operations.
+ */
+class ConnectionInfos
+{
+    typedef std::list<ConnectionInfo> ListType;
+public:
+    typedef ListType::const_iterator const_iterator;
+
+    ConnectionInfos(void);
+
+    ConnectionInfos(const ConnectionInfos &other);
+
+    ConnectionInfos(ConnectionInfos &&other) = default;
+
+    ConnectionInfos &operator=(const ConnectionInfos &other);
+
+    ConnectionInfos &operator=(ConnectionInfos &&other) = default;
+
+    //! Add a connection to the end, no effect if already present
+    void insert(const ConnectionInfo &info);
+
+    //! Remove a connection, no effect if not present
+    void remove(const ConnectionInfo &info);
+
+    //! Is this connection present in the set?
+    bool contains(const ConnectionInfo &info) const
+    {
+        return _index.count(info) != 0;
+    }
+
+    size_t size(void) const
+    {
+        return _infos.size();
+    }
+
+    bool empty(void) const
+    {
+        return _infos.empty();
+    }
+
+    void clear(void);
+
+    const_iterator begin(void) const
+    {
+        return _infos.begin();
+    }
+
+    const_iterator end(void) const
+    {
+        return _infos.end();
+    }
+
+private:
+    ListType _infos;
+    std::unordered_map<ConnectionInfo, const_iterator, ConnectionInfoHash> _index;
+};
+
+//! Calculates set(in0 - in1)
+ConnectionInfos diffConnectionInfos(const ConnectionInfos &in0, const ConnectionInfos &in1);
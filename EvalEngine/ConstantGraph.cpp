@@ -0,0 +1,62 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConstantGraph.hpp"
+#include <QRegularExpression>
+#include <QStringList>
+#include <vector>
+
+ConstantGraph::ConstantGraph(const std::map<QString, QString> &constants):
+    _constants(constants)
+{
+    //direct dependencies of each constant on other constants
+    std::map<QString, QSet<QString>> direct;
+    for (const auto &pair : _constants)
+    {
+        auto &deps = direct[pair.first];
+        for (const auto &tok : tokenize(pair.second))
+        {
+            if (_constants.count(tok) != 0) deps.insert(tok);
+        }
+    }
+
+    //traverse the dependencies to build the transitive closure,
+    //the visited set terminates loops in the constant expressions
+    for (const auto &pair : direct)
+    {
+        auto &closure = _closure[pair.first];
+        std::vector<QString> stack(1, pair.first);
+        while (not stack.empty())
+        {
+            const auto name = stack.back();
+            stack.pop_back();
+            if (closure.contains(name)) continue;
+            closure.insert(name);
+            for (const auto &dep : direct.at(name)) stack.push_back(dep);
+        }
+    }
+}
+
+QSet<QString> ConstantGraph::getConstantsUsed(const QSet<QString> &symbols) const
+{
+    QSet<QString> used;
+    for (const auto &sym : symbols)
+    {
+        auto it = _closure.find(sym);
+        if (it != _closure.end()) used += it->second;
+    }
+    return used;
+}
+
+QSet<QString> ConstantGraph::tokenize(const QString &expr)
+{
+    static thread_local const QRegularExpression nonWord("\\W");
+    #if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
+        #define behavior QString::SkipEmptyParts
+    #else
+        #define behavior Qt::SkipEmptyParts //old flags deprecated in 5.14
+    #endif
+    QSet<QString> symbols;
+    for (const auto &tok : expr.split(nonWord, behavior)) symbols.insert(tok);
+    return symbols;
+}
@@ -0,0 +1,43 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Config.hpp>
+#include <QString>
+#include <QSet>
+#include <map>
+
+/*!
+ * The constant graph holds the global constant expressions
+ * parsed into a dependency graph with the transitive closure.
+ * It is created once per submit and shared between block infos.
+ * The graph is immutable and safe to read from any thread.
+ */
+class ConstantGraph
+{
+public:
+
+    //! Parse the constant expressions into the dependency graph
+    ConstantGraph(const std::map<QString, QString> &constants);
+
+    //! Was this graph created from the same constant expressions?
+    bool isMatch(const std::map<QString, QString> &constants) const
+    {
+        return _constants == constants;
+    }
+
+    /*!
+     * Get all constants used by a set of expression symbols.
+     * This includes the transitive dependencies of each constant.
+     */
+    QSet<QString> getConstantsUsed(const QSet<QString> &symbols) const;
+
+    //! Split an expression into its set of symbol tokens
+    static QSet<QString> tokenize(const QString &expr);
+
+private:
+    std::map<QString, QString> _constants;
+
+    //! each constant maps to itself and all of its dependencies
+    std::map<QString, QSet<QString>> _closure;
+};
@@ -1,7 +1,10 @@
-// Copyright (c) 2014-2017 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #include "EnvironmentEval.hpp"
+#include "EnvironmentHeartbeat.hpp"
+#include "EnvironmentPool.hpp"
+#include "BlockInstanceCache.hpp"
 #include "EvalTracer.hpp"
 #include <Pothos/Proxy.hpp>
 #include <Pothos/Remote.hpp>
@@ -9,8 +12,23 @@
 #include <Pothos/Util/Network.hpp>
 #include <Poco/URI.h>
 #include <Poco/Net/SocketAddress.h>
+#include <chrono>
+#include <mutex>
+#include <algorithm> //max
 
-EnvironmentEval::EnvironmentEval(void):
+//! The default timeout to connect to a host when spawning an environment
+static const int DEFAULT_SPAWN_TIMEOUT_MS = 5000;
+
+//! The number of dropped blocks kept for reuse per environment
+static const size_t BLOCK_INSTANCE_CACHE_CAPACITY = 16;
+
+//! How long a dropped block is kept for reuse before it is released
+static const int BLOCK_INSTANCE_CACHE_TTL_MS = 30000;
+
+EnvironmentEval::EnvironmentEval(const std::shared_ptr<EnvironmentPool> &envPool):
+    _envPool(envPool),
+    _blockCache(new BlockInstanceCache(BLOCK_INSTANCE_CACHE_CAPACITY,
+        std::chrono::milliseconds(BLOCK_INSTANCE_CACHE_TTL_MS))),
     _failureState(false),
     _logger(Poco::Logger::get("PothosFlow.EnvironmentEval"))
 {
@@ -19,7 +37,7 @@ EnvironmentEval::EnvironmentEval(void):
 
 EnvironmentEval::~EnvironmentEval(void)
 {
-    return;
+    _heartbeat.reset();
 }
 
 void EnvironmentEval::acceptConfig(const QString &zoneName, const QJsonObject &config)
@@ -31,45 +49,104 @@ void EnvironmentEval::acceptConfig(const QString &zoneName, const QJsonObject &c
 void EnvironmentEval::update(void)
 {
     EVAL_TRACER_FUNC_ARG(_zoneName);
-    if (this->isFailureState()) _env.reset();
 
-    try
+    //release the dropped blocks that were not reused in time
+    _blockCache->expire();
+
+    //the heartbeat monitors remote environments in a separate thread
+    if (not _heartbeat and _zoneName != "gui")
     {
-        //env already exists, try test communication
-        if (_env)
-        {
-            _env->findProxy("Pothos/Util/EvalEnvironment");
-        }
-        //otherwise, make a new env
-        else
-        {
-            _env = this->makeEnvironment();
-            auto EvalEnvironment = _env->findProxy("Pothos/Util/EvalEnvironment");
-            _eval = EvalEnvironment.call("make");
-            _failureState = false;
-        }
+        const auto hostUri = getHostProcFromConfig(_zoneName, _config).first;
+        _heartbeat.reset(new EnvironmentHeartbeat(hostUri));
     }
-    catch (const Pothos::Exception &ex)
+    if (_heartbeat) _heartbeat->setInterval(std::chrono::milliseconds(
+        _config["heartbeatIntervalMs"].toInt(DEFAULT_HEARTBEAT_INTERVAL_MS)));
+
+    //env already exists, check the cached heartbeat state
+    if (_env)
     {
-        //dont report errors if we were already in failure mode
-        if (_failureState) return;
-        _failureState = true;
+        if (not _heartbeat or _heartbeat->isAlive()) return;
 
         //determine if the remote host is offline or the process just crashed
         const auto hostUri = getHostProcFromConfig(_zoneName, _config).first;
-        try
-        {
-            Pothos::RemoteClient client(hostUri.toStdString());
-            _errorMsg = tr("Remote environment %1 crashed").arg(_zoneName);
-        }
-        catch(const Pothos::RemoteClientError &)
+        if (_heartbeat->isHostReachable()) this->reportFailure(
+            tr("Remote environment %1 crashed").arg(_zoneName), _heartbeat->getErrorMsg());
+        else this->reportFailure(
+            tr("Remote host %1 is offline").arg(hostUri), _heartbeat->getErrorMsg());
+        return;
+    }
+
+    //while failing, only retry when the heartbeat reached the host,
+    //the heartbeat probes the host with an exponential backoff
+    if (_failureState and _heartbeat and not _heartbeat->isHostReachable()) return;
+
+    //otherwise, make a new env
+    try
+    {
+        EVAL_TRACER_ACTION_ARG("makeEnvironment", _zoneName);
+        auto env = this->makeEnvironment();
+        auto EvalEnvironment = env->findProxy("Pothos/Util/EvalEnvironment");
+        _eval = EvalEnvironment.call("make");
+        _blockCache->clear();
+        _env = env;
+        _failureState = false;
         {
-            _errorMsg = tr("Remote host %1 is offline").arg(hostUri);
+            //the new environment may run a different server, probe again
+            std::lock_guard<std::mutex> lock(_unsupportedCallsMutex);
+            _unsupportedCalls.clear();
         }
-        _logger.error("zone[%s]: %s - %s", _zoneName.toStdString(), ex.displayText(), _errorMsg.toStdString());
+        if (_heartbeat) _heartbeat->lease(_env);
+    }
+    catch (const Pothos::RemoteClientError &ex)
+    {
+        if (_heartbeat) _heartbeat->reportFailure();
+        const auto hostUri = getHostProcFromConfig(_zoneName, _config).first;
+        this->reportFailure(tr("Remote host %1 is offline").arg(hostUri), ex.displayText());
+    }
+    catch (const Pothos::Exception &ex)
+    {
+        if (_heartbeat) _heartbeat->reportFailure();
+        this->reportFailure(tr("Remote environment %1 crashed").arg(_zoneName), ex.displayText());
     }
 }
 
+void EnvironmentEval::probe(void)
+{
+    EVAL_TRACER_FUNC_ARG(_zoneName);
+    if (_heartbeat) _heartbeat->ping();
+    this->update();
+}
+
+bool EnvironmentEval::isCallUnsupported(const std::string &name) const
+{
+    std::lock_guard<std::mutex> lock(_unsupportedCallsMutex);
+    return _unsupportedCalls.count(name) != 0;
+}
+
+void EnvironmentEval::setCallUnsupported(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(_unsupportedCallsMutex);
+    _unsupportedCalls.insert(name);
+}
+
+bool EnvironmentEval::isMissingCallError(const std::string &errorMsg)
+{
+    return errorMsg.find("method does not exist") != std::string::npos;
+}
+
+void EnvironmentEval::reportFailure(const QString &errorMsg, const std::string &reason)
+{
+    _blockCache->clear();
+    _env.reset();
+    _eval = Pothos::Proxy();
+
+    //dont report errors if we were already in failure mode
+    if (_failureState) return;
+    _failureState = true;
+    _errorMsg = errorMsg;
+    _logger.error("zone[%s]: %s - %s", _zoneName.toStdString(), reason, _errorMsg.toStdString());
+}
+
 HostProcPair EnvironmentEval::getHostProcFromConfig(const QString &zoneName, const QJsonObject &config)
 {
     if (zoneName == "gui") return HostProcPair(QString::fromStdString("gui://"+Pothos::Util::getLoopbackAddr()), "gui");
@@ -80,30 +157,49 @@ HostProcPair EnvironmentEval::getHostProcFromConfig(const QString &zoneName, con
     return HostProcPair(hostUri, processName);
 }
 
+long EnvironmentEval::getSpawnTimeoutUs(void) const
+{
+    return getSpawnTimeoutUsFromConfig(_config);
+}
+
+long EnvironmentEval::getSpawnTimeoutUsFromConfig(const QJsonObject &config)
+{
+    return long(config["spawnTimeoutMs"].toInt(DEFAULT_SPAWN_TIMEOUT_MS))*1000;
+}
+
+void EnvironmentEval::mergePoolConfig(const QString &zoneName, const QJsonObject &config, std::map<std::string, EnvironmentPoolConfig> &configs)
+{
+    if (zoneName == "gui") return; //the gui environment is not spawned
+
+    //zones on the same host share the pool, keep the largest settings
+    const auto hostUri = getHostProcFromConfig(zoneName, config).first.toStdString();
+    auto &poolConfig = configs[hostUri];
+    poolConfig.size = std::max(poolConfig.size,
+        size_t(std::max(0, config["environmentPoolSize"].toInt(DEFAULT_ENVIRONMENT_POOL_SIZE))));
+    poolConfig.timeoutUs = std::max(poolConfig.timeoutUs, getSpawnTimeoutUsFromConfig(config));
+}
+
 Pothos::ProxyEnvironment::Sptr EnvironmentEval::makeEnvironment(void)
 {
     if (_zoneName == "gui") return Pothos::ProxyEnvironment::make("managed");
 
     const auto hostUri = getHostProcFromConfig(_zoneName, _config).first.toStdString();
+    const auto timeoutUs = this->getSpawnTimeoutUs();
 
-    //connect to the remote host and spawn a server
-    auto serverEnv = Pothos::RemoteClient(hostUri).makeEnvironment("managed");
-    auto serverHandle = serverEnv->findProxy("Pothos/RemoteServer")("tcp://"+Pothos::Util::getWildcardAddr(), false/*noclose*/);
-
-    //construct the uri for the new server
-    std::string actualPort = serverHandle.call("getActualPort");
-    Poco::URI newHostUri(hostUri);
-    newHostUri.setPort(std::stoul(actualPort));
-
-    //connect the client environment
-    auto client = Pothos::RemoteClient(newHostUri.toString());
-    client.holdRef(Pothos::Object(serverHandle));
-    auto env = client.makeEnvironment("managed");
+    //claim a warm environment from the pool or spawn a new one
+    const auto spawned = _envPool?_envPool->claim(hostUri, timeoutUs):EnvironmentPool::spawn(hostUri, timeoutUs);
+    const auto &env = spawned.env;
+    const auto &serverHandle = spawned.serverHandle;
+    const Poco::URI newHostUri(spawned.serverUri);
 
     //determine log delivery address
     //FIXME syslog listener doesn't support IPv6, special precautions taken:
     const auto logSource = (not _zoneName.isEmpty())? _zoneName.toStdString() : newHostUri.getHost();
+    //environments are spawned concurrently, serialize the shared listener setup
+    static std::mutex syslogListenerMutex;
+    std::unique_lock<std::mutex> syslogLock(syslogListenerMutex);
     const auto syslogListenPort = Pothos::System::Logger::startSyslogListener();
+    syslogLock.unlock();
     Poco::Net::SocketAddress serverAddr(env->getPeeringAddress(), syslogListenPort);
 
     //deal with IPv6 addresses because the syslog server only binds to IPv4
@@ -1,4 +1,4 @@
-// Copyright (c) 2014-2017 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #pragma once
@@ -9,8 +9,17 @@
 #include <QString>
 #include <memory>
 #include <utility>
+#include <string>
+#include <mutex>
+#include <map>
+#include <set>
 #include <Poco/Logger.h>
 
+class EnvironmentHeartbeat;
+class EnvironmentPool;
+class BlockInstanceCache;
+struct EnvironmentPoolConfig;
+
 typedef std::pair<QString, QString> HostProcPair;
 
 class EnvironmentEval : public QObject
@@ -18,7 +27,8 @@ class EnvironmentEval : public QObject
     Q_OBJECT
 public:
 
-    EnvironmentEval(void);
+    //! Create an environment eval which claims from the pool (optional)
+    EnvironmentEval(const std::shared_ptr<EnvironmentPool> &envPool = std::shared_ptr<EnvironmentPool>());
 
     ~EnvironmentEval(void);
 
@@ -30,12 +40,30 @@ public:
 
     /*!
      * Deal with changes from the latest config.
+     * Liveness is read from the cached heartbeat state,
+     * so this call does not block on remote communication
+     * unless a new environment needs to be created.
+     * Separate environment evals may update concurrently.
      */
     void update(void);
 
+    /*!
+     * Check the liveness of the environment right away, then update.
+     * Used after a block failed to construct, which may have crashed
+     * the environment before the next heartbeat would notice.
+     * This call blocks on remote communication.
+     */
+    void probe(void);
+
     //! Shared method to parse the zone config into host uri and process name
     static HostProcPair getHostProcFromConfig(const QString &zoneName, const QJsonObject &config);
 
+    /*!
+     * Merge the warm environment settings of a zone into the host configs.
+     * Zones on the same host keep the largest pool size and spawn timeout.
+     */
+    static void mergePoolConfig(const QString &zoneName, const QJsonObject &config, std::map<std::string, EnvironmentPoolConfig> &configs);
+
     //! Get access to the proxy environment
     Pothos::ProxyEnvironment::Sptr getEnv(void) const
     {
@@ -48,6 +76,28 @@ public:
         return _eval;
     }
 
+    /*!
+     * Get the cache of dropped blocks in this environment.
+     * The cache is cleared when the environment is replaced.
+     */
+    BlockInstanceCache &getBlockInstanceCache(void) const
+    {
+        return *_blockCache;
+    }
+
+    /*!
+     * Is a call known to be missing from the remote evaluators?
+     * Batched calls are probed by their first use in each environment,
+     * and a missing call falls back to the per-call path from then on.
+     */
+    bool isCallUnsupported(const std::string &name) const;
+
+    //! Record a call that the remote evaluators do not implement
+    void setCallUnsupported(const std::string &name);
+
+    //! Is the exception from a call that the remote object does not implement?
+    static bool isMissingCallError(const std::string &errorMsg);
+
     //! An error caused the environment to go into failure state
     bool isFailureState(void) const
     {
@@ -62,12 +112,22 @@ public:
 
 private:
     Pothos::ProxyEnvironment::Sptr makeEnvironment(void);
+    long getSpawnTimeoutUs(void) const;
+    static long getSpawnTimeoutUsFromConfig(const QJsonObject &config);
+
+    //! Enter the failure state with an error message
+    void reportFailure(const QString &errorMsg, const std::string &reason);
 
     QString _zoneName;
     QJsonObject _config;
     Pothos::ProxyEnvironment::Sptr _env;
     Pothos::Proxy _eval;
+    std::shared_ptr<EnvironmentPool> _envPool;
+    std::unique_ptr<EnvironmentHeartbeat> _heartbeat;
+    std::unique_ptr<BlockInstanceCache> _blockCache;
     bool _failureState;
+    mutable std::mutex _unsupportedCallsMutex;
+    std::set<std::string> _unsupportedCalls;
     QString _errorMsg;
     Poco::Logger &_logger;
 };
@@ -0,0 +1,158 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "EnvironmentHeartbeat.hpp"
+#include <Pothos/Proxy.hpp>
+#include <Pothos/Remote.hpp>
+#include <algorithm> //min/max
+
+//! The backoff while failing doubles up to this maximum
+static const std::chrono::milliseconds MAX_BACKOFF(30000);
+
+//! Timeout for connecting to the host when probing
+static const long PROBE_TIMEOUT_US = 1000000;
+
+//! Test communication with the environment
+static bool pingEnvironment(const Pothos::ProxyEnvironment::Sptr &env, std::string &errorMsg)
+{
+    try
+    {
+        env->findProxy("Pothos/Util/EvalEnvironment");
+        return true;
+    }
+    catch (const Pothos::Exception &ex)
+    {
+        errorMsg = ex.displayText();
+        return false;
+    }
+}
+
+//! Can the remote host be reached at all?
+static bool probeHost(const std::string &hostUri)
+{
+    try
+    {
+        Pothos::RemoteClient client(hostUri, PROBE_TIMEOUT_US);
+        return true;
+    }
+    catch (const Pothos::Exception &)
+    {
+        return false;
+    }
+}
+
+EnvironmentHeartbeat::EnvironmentHeartbeat(const QString &hostUri):
+    _hostUri(hostUri.toStdString()),
+    _interval(DEFAULT_HEARTBEAT_INTERVAL_MS),
+    _alive(false),
+    _hostReachable(false),
+    _done(false)
+{
+    _thread = std::thread(&EnvironmentHeartbeat::run, this);
+}
+
+EnvironmentHeartbeat::~EnvironmentHeartbeat(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _done = true;
+    }
+    _cond.notify_one();
+    _thread.join();
+}
+
+void EnvironmentHeartbeat::setInterval(const std::chrono::milliseconds &interval)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _interval = std::max(interval, std::chrono::milliseconds(1));
+}
+
+void EnvironmentHeartbeat::lease(const Pothos::ProxyEnvironment::Sptr &env)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _env = env;
+        _errorMsg.clear();
+        _alive = true;
+        _hostReachable = true;
+    }
+    _cond.notify_one();
+}
+
+void EnvironmentHeartbeat::reportFailure(void)
+{
+    //the next probe will determine if the host is reachable,
+    //the backoff continues to increase while creation fails
+    std::lock_guard<std::mutex> lock(_mutex);
+    _env.reset();
+    _alive = false;
+    _hostReachable = false;
+}
+
+void EnvironmentHeartbeat::ping(void)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    const auto env = _env;
+    if (not env) return;
+
+    //perform the ping and probe without holding the lock
+    lock.unlock();
+    std::string errorMsg;
+    if (pingEnvironment(env, errorMsg)) return;
+    const bool probeOk = probeHost(_hostUri);
+    lock.lock();
+
+    //a new lease arrived during the ping, discard the result
+    if (_env != env) return;
+    _errorMsg = errorMsg;
+    _env.reset();
+    _alive = false;
+    _hostReachable = probeOk;
+
+    //wake the thread to probe the host from the start of the backoff
+    lock.unlock();
+    _cond.notify_one();
+}
+
+std::string EnvironmentHeartbeat::getErrorMsg(void) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _errorMsg;
+}
+
+void EnvironmentHeartbeat::run(void)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto backoff = _interval;
+    while (not _done)
+    {
+        //wait for the interval when alive or the backoff when failing,
+        //a new lease or shutdown request wakes the thread immediately
+        auto env = _env;
+        _cond.wait_for(lock, env?_interval:backoff, [&]{return _done or _env != env;});
+        if (_done) break;
+        if (_env != env)
+        {
+            backoff = _interval;
+            continue;
+        }
+
+        //perform the ping or probe without holding the lock
+        std::string errorMsg;
+        lock.unlock();
+        const bool pingOk = env and pingEnvironment(env, errorMsg);
+        const bool probeOk = not pingOk and probeHost(_hostUri);
+        lock.lock();
+
+        //a new lease arrived during the ping, discard the result
+        if (_env != env) continue;
+        if (pingOk) continue;
+
+        //the environment is down, probe again with a backoff
+        if (env) _errorMsg = errorMsg;
+        _env.reset();
+        _alive = false;
+        _hostReachable = probeOk;
+        backoff = std::min(std::max(backoff*2, _interval), MAX_BACKOFF);
+    }
+}
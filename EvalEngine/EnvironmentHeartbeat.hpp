@@ -0,0 +1,79 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Config.hpp>
+#include <Pothos/Proxy/Environment.hpp>
+#include <QString>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <string>
+
+//! The default interval between heartbeat pings of an environment
+static const int DEFAULT_HEARTBEAT_INTERVAL_MS = 1000;
+
+/*!
+ * The environment heartbeat monitors the liveness of an environment
+ * with a cheap periodic ping from a dedicated thread, and caches the
+ * up/down state so that the eval thread never blocks on a remote call.
+ * While the environment is down, the heartbeat probes the remote host
+ * with an exponential backoff to determine if the host is reachable.
+ */
+class EnvironmentHeartbeat
+{
+public:
+
+    //! Create a heartbeat for environments on the given host
+    EnvironmentHeartbeat(const QString &hostUri);
+
+    //! Stop the heartbeat thread
+    ~EnvironmentHeartbeat(void);
+
+    //! Set the interval between pings of a live environment
+    void setInterval(const std::chrono::milliseconds &interval);
+
+    //! Begin monitoring a newly created environment
+    void lease(const Pothos::ProxyEnvironment::Sptr &env);
+
+    //! Creation of a new environment failed, resume probing the host
+    void reportFailure(void);
+
+    /*!
+     * Ping the leased environment right away from the calling thread.
+     * Used after a failed evaluation, which may have crashed the environment.
+     * Unlike the cached state getters, this blocks on a remote call.
+     */
+    void ping(void);
+
+    //! Is the leased environment alive? (cached state)
+    bool isAlive(void) const
+    {
+        return _alive;
+    }
+
+    //! Was the host reachable on the last probe? (cached state)
+    bool isHostReachable(void) const
+    {
+        return _hostReachable;
+    }
+
+    //! Get the error message from the last failed ping
+    std::string getErrorMsg(void) const;
+
+private:
+    void run(void);
+
+    const std::string _hostUri;
+    std::chrono::milliseconds _interval;
+    Pothos::ProxyEnvironment::Sptr _env;
+    std::string _errorMsg;
+    std::atomic<bool> _alive;
+    std::atomic<bool> _hostReachable;
+    bool _done;
+    mutable std::mutex _mutex;
+    std::condition_variable _cond;
+    std::thread _thread;
+};
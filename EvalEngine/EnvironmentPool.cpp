@@ -0,0 +1,193 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "EnvironmentPool.hpp"
+#include <Pothos/Remote.hpp>
+#include <Pothos/Util/Network.hpp>
+#include <Poco/URI.h>
+#include <algorithm> //min
+
+//! Delay before retrying to warm a host after a failed spawn
+static const std::chrono::milliseconds SPAWN_RETRY_DELAY(5000);
+
+EnvironmentPool::EnvironmentPool(void):
+    _done(false),
+    _logger(Poco::Logger::get("PothosFlow.EnvironmentPool"))
+{
+    _thread = std::thread(&EnvironmentPool::run, this);
+}
+
+EnvironmentPool::~EnvironmentPool(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _done = true;
+    }
+    _cond.notify_one();
+    _thread.join();
+}
+
+void EnvironmentPool::setPoolConfigs(const std::map<std::string, EnvironmentPoolConfig> &configs)
+{
+    std::list<SpawnedEnvironment> excess;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (const auto &pair : configs) _pools[pair.first]; //create new pools
+
+        for (auto it = _pools.begin(); it != _pools.end();)
+        {
+            //hosts that are no longer in use shrink to nothing
+            auto &pool = it->second;
+            const auto configIt = configs.find(it->first);
+            pool.config = (configIt == configs.end())?EnvironmentPoolConfig():configIt->second;
+            while (pool.ready.size() > pool.config.size)
+            {
+                excess.splice(excess.end(), pool.ready, pool.ready.begin());
+            }
+            if (configIt == configs.end()) it = _pools.erase(it);
+            else it++;
+        }
+    }
+    _cond.notify_one();
+    //excess environments are released outside of the lock
+}
+
+SpawnedEnvironment EnvironmentPool::claim(const std::string &hostUri, const long timeoutUs)
+{
+    while (true)
+    {
+        //take the oldest warm environment for this host
+        SpawnedEnvironment spawned;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _pools.find(hostUri);
+            if (it == _pools.end() or it->second.ready.empty()) break;
+            auto &ready = it->second.ready;
+            spawned = ready.front();
+            ready.pop_front();
+        }
+
+        //the background thread replaces the claimed environment
+        _cond.notify_one();
+
+        //an idle environment may have died, check before handing it out
+        try
+        {
+            spawned.env->findProxy("Pothos/Util/EvalEnvironment");
+            return spawned;
+        }
+        catch (const Pothos::Exception &ex)
+        {
+            _logger.warning("Discarding warm environment on %s - %s", hostUri, ex.displayText());
+        }
+    }
+
+    //nothing warm is available, spawn on demand
+    return spawn(hostUri, timeoutUs);
+}
+
+SpawnedEnvironment EnvironmentPool::spawn(const std::string &hostUri, const long timeoutUs)
+{
+    //connect to the remote host and spawn a server
+    auto serverEnv = Pothos::RemoteClient(hostUri, timeoutUs).makeEnvironment("managed");
+    auto serverHandle = serverEnv->findProxy("Pothos/RemoteServer")("tcp://"+Pothos::Util::getWildcardAddr(), false/*noclose*/);
+
+    //construct the uri for the new server
+    std::string actualPort = serverHandle.call("getActualPort");
+    Poco::URI newHostUri(hostUri);
+    newHostUri.setPort(std::stoul(actualPort));
+
+    //connect the client environment
+    auto client = Pothos::RemoteClient(newHostUri.toString(), timeoutUs);
+    client.holdRef(Pothos::Object(serverHandle));
+
+    SpawnedEnvironment spawned;
+    spawned.env = client.makeEnvironment("managed");
+    spawned.serverHandle = serverHandle;
+    spawned.serverUri = newHostUri.toString();
+    return spawned;
+}
+
+void EnvironmentPool::run(void)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (not _done)
+    {
+        //find a host pool that needs another environment
+        const auto now = std::chrono::steady_clock::now();
+        auto nextRetry = std::chrono::steady_clock::time_point::max();
+        std::string hostUri;
+        long timeoutUs(0);
+        for (const auto &pair : _pools)
+        {
+            const auto &pool = pair.second;
+            if (pool.ready.size() >= pool.config.size) continue;
+            if (pool.retryTime > now)
+            {
+                nextRetry = std::min(nextRetry, pool.retryTime);
+                continue;
+            }
+            hostUri = pair.first;
+            timeoutUs = pool.config.timeoutUs;
+            break;
+        }
+
+        //nothing to spawn, wait for a claim, config change, or retry
+        if (hostUri.empty())
+        {
+            if (nextRetry == std::chrono::steady_clock::time_point::max()) _cond.wait(lock);
+            else _cond.wait_until(lock, nextRetry);
+            continue;
+        }
+
+        //spawn and warm the environment without holding the lock
+        SpawnedEnvironment spawned;
+        std::string errorMsg;
+        lock.unlock();
+        try
+        {
+            spawned = spawn(hostUri, timeoutUs);
+            spawned.env->findProxy("Pothos/Util/EvalEnvironment");
+        }
+        catch (const Pothos::Exception &ex)
+        {
+            spawned = SpawnedEnvironment();
+            errorMsg = ex.displayText();
+        }
+        lock.lock();
+
+        //the host may have been released during the spawn
+        auto poolIt = _pools.find(hostUri);
+        if (poolIt == _pools.end())
+        {
+            lock.unlock();
+            spawned = SpawnedEnvironment();
+            lock.lock();
+            continue;
+        }
+        auto &pool = poolIt->second;
+        if (not spawned.env)
+        {
+            _logger.warning("Failed to warm environment on %s - %s", hostUri, errorMsg);
+            pool.retryTime = std::chrono::steady_clock::now() + SPAWN_RETRY_DELAY;
+            continue;
+        }
+
+        //only keep the environment when the pool still has room
+        if (pool.ready.size() < pool.config.size)
+        {
+            pool.ready.push_back(spawned);
+            continue;
+        }
+
+        //otherwise release it outside of the lock
+        lock.unlock();
+        spawned = SpawnedEnvironment();
+        lock.lock();
+    }
+
+    //release idle environments outside of the lock
+    std::map<std::string, HostPool> pools;
+    pools.swap(_pools);
+    lock.unlock();
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Config.hpp>
+#include <Pothos/Proxy.hpp>
+#include <Poco/Logger.h>
+#include <condition_variable>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <list>
+#include <map>
+
+//! The default number of warm environments kept per host,
+//! none unless a zone opts in, each one is an idle server process
+static const int DEFAULT_ENVIRONMENT_POOL_SIZE = 0;
+
+/*!
+ * A managed environment in a newly spawned server process.
+ */
+struct SpawnedEnvironment
+{
+    Pothos::ProxyEnvironment::Sptr env;
+    Pothos::Proxy serverHandle;
+    std::string serverUri;
+};
+
+/*!
+ * The warm environment settings for a host.
+ * Zones on the same host are merged into one config.
+ */
+struct EnvironmentPoolConfig
+{
+    size_t size{0};
+    long timeoutUs{0};
+};
+
+/*!
+ * The environment pool keeps a configurable number of pre-spawned,
+ * plugin-loaded managed environments per host warm in the background.
+ * Environment evals claim from the pool on demand to avoid the cost
+ * of spawning a server process, and claimed environments are replaced
+ * asynchronously by the pool's background thread.
+ */
+class EnvironmentPool
+{
+public:
+
+    //! Create the pool and start the background thread
+    EnvironmentPool(void);
+
+    //! Stop the background thread and release idle environments
+    ~EnvironmentPool(void);
+
+    /*!
+     * Set the warm environment settings for every host in use.
+     * The pools of hosts that are not in the map are released.
+     * \param configs a map of host uri to pool settings
+     */
+    void setPoolConfigs(const std::map<std::string, EnvironmentPoolConfig> &configs);
+
+    /*!
+     * Claim a warm environment for the host,
+     * or spawn a new one when none are available.
+     * Throws on failure to spawn an environment.
+     */
+    SpawnedEnvironment claim(const std::string &hostUri, const long timeoutUs);
+
+    //! Spawn a new server process on the host and connect to it
+    static SpawnedEnvironment spawn(const std::string &hostUri, const long timeoutUs);
+
+private:
+    void run(void);
+
+    struct HostPool
+    {
+        EnvironmentPoolConfig config;
+        std::list<SpawnedEnvironment> ready;
+        std::chrono::steady_clock::time_point retryTime;
+    };
+
+    std::map<std::string, HostPool> _pools;
+    bool _done;
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    Poco::Logger &_logger;
+    std::thread _thread;
+};
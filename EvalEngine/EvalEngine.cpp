@@ -1,9 +1,10 @@
-// Copyright (c) 2014-2021 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #include "EvalEngine.hpp"
 #include "EvalTracer.hpp"
 #include "EvalEngineImpl.hpp"
+#include "ConstantGraph.hpp"
 #include "GraphObjects/GraphBlock.hpp"
 #include "GraphEditor/GraphDraw.hpp"
 #include "GraphEditor/GraphEditor.hpp"
@@ -53,22 +54,29 @@ EvalEngine::~EvalEngine(void)
     delete _tracer;
 }
 
-static BlockInfo blockToBlockInfo(GraphBlock *block)
+static BlockInfo blockToBlockInfo(GraphBlock *block, std::shared_ptr<const ConstantGraph> &constantGraph)
 {
     BlockInfo blockInfo;
     blockInfo.block = block;
     blockInfo.isGraphWidget = block->isGraphWidget();
+    blockInfo.descPending = block->isBlockDescPending();
     blockInfo.id = block->getId();
     blockInfo.uid = block->uid();
     blockInfo.enabled = block->isEnabled();
     blockInfo.zone = block->getAffinityZone();
-    blockInfo.desc = block->getBlockDesc();
+    blockInfo.desc = block->getSharedBlockDesc();
     const auto editor = block->draw()->getGraphEditor();
     blockInfo.constantNames = editor->listGlobals();
     for (const auto &name : blockInfo.constantNames)
     {
         blockInfo.constants[name] = editor->getGlobalExpression(name);;
     }
+    //parse the constants once and share the graph between blocks
+    if (not constantGraph or not constantGraph->isMatch(blockInfo.constants))
+    {
+        constantGraph.reset(new ConstantGraph(blockInfo.constants));
+    }
+    blockInfo.constantGraph = constantGraph;
     for (const auto &propKey : block->getProperties())
     {
         blockInfo.properties[propKey] = block->getPropertyValue(propKey);
@@ -86,7 +94,7 @@ void EvalEngine::submitTopology(const GraphObjectList &graphObjects)
         auto block = qobject_cast<GraphBlock *>(obj);
         if (block == nullptr) continue;
         connect(block, &GraphBlock::triggerEvalEvent, [=](void){this->submitBlock(block);});
-        blockInfos[block->uid()] = blockToBlockInfo(block);
+        blockInfos[block->uid()] = blockToBlockInfo(block, _constantGraph);
     }
 
     //create a list of connection eval information
@@ -112,7 +120,7 @@ void EvalEngine::submitBlock(QObject *obj)
 {
     auto block = qobject_cast<GraphBlock *>(obj);
     assert(block != nullptr);
-    _impl->invokeMethod("submitBlock", Qt::QueuedConnection, Q_ARG(BlockInfo, blockToBlockInfo(block)));
+    _impl->invokeMethod("submitBlock", Qt::QueuedConnection, Q_ARG(BlockInfo, blockToBlockInfo(block, _constantGraph)));
 }
 
 QByteArray EvalEngine::getTopologyDotMarkup(const QByteArray &config)
@@ -136,6 +144,23 @@ QByteArray EvalEngine::getTopologyJSONStats(void)
     return result;
 }
 
+QByteArray EvalEngine::getEvalJSONStats(void)
+{
+    QByteArray result;
+    _impl->invokeMethod("getEvalJSONStats", Qt::BlockingQueuedConnection, Q_RETURN_ARG(QByteArray, result));
+    return result;
+}
+
+void EvalEngine::setTraceRecording(const bool enable)
+{
+    _tracer->setRecording(enable);
+}
+
+QByteArray EvalEngine::getEvalChromeTrace(void)
+{
+    return _tracer->toChromeTrace();
+}
+
 void EvalEngine::handleAffinityZonesChanged(void)
 {
     ZoneInfos zoneInfos;
@@ -7,12 +7,14 @@
 #include <Poco/Logger.h>
 #include <QObject>
 #include <chrono>
+#include <memory>
 
 class QThread;
 class QTimer;
 class EvalEngineImpl;
 class AffinityZonesDock;
 class EvalTracer;
+class ConstantGraph;
 
 /*!
  * The EvalEngine is the entry point for submitting design changes.
@@ -66,6 +68,15 @@ public slots:
     //! query the JSON stats for the active topology
     QByteArray getTopologyJSONStats(void);
 
+    //! query the JSON stats for the evaluator (blocks evaluated vs skipped)
+    QByteArray getEvalJSONStats(void);
+
+    //! enable or disable recording of timed evaluation spans
+    void setTraceRecording(const bool enable);
+
+    //! query the recorded evaluation spans as Chrome trace JSON
+    QByteArray getEvalChromeTrace(void);
+
 private slots:
     void handleAffinityZonesChanged(void);
     void handleEvalThreadHeartBeat(void);
@@ -80,4 +91,5 @@ private:
     EvalEngineImpl *_impl;
     AffinityZonesDock *_affinityDock;
     std::chrono::system_clock::time_point _lastHeartBeat;
+    std::shared_ptr<const ConstantGraph> _constantGraph;
 };
@@ -1,23 +1,33 @@
-// Copyright (c) 2014-2021 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #include "EvalEngineImpl.hpp"
 #include "EvalEngine.hpp"
 #include "EvalTracer.hpp"
+#include "EvalMetrics.hpp"
 #include "BlockEval.hpp"
 #include "ThreadPoolEval.hpp"
 #include "EnvironmentEval.hpp"
+#include "EnvironmentPool.hpp"
+#include "BlockInstanceCache.hpp"
 #include "TopologyEval.hpp"
 #include "GraphObjects/GraphBlock.hpp"
 #include <Pothos/Framework/Topology.hpp>
 #include <QApplication>
 #include <QThread>
 #include <QTimer>
+#include <QThreadPool>
+#include <QFuture>
+#include <QtConcurrent/QtConcurrent>
 #include <QAbstractEventDispatcher>
+#include <QJsonDocument>
 #include <cassert>
 
 static const int MONITOR_INTERVAL_MS = 1000;
 
+//! Maximum number of environments spawned and updated concurrently
+static const int MAX_WORKER_THREADS = 32;
+
 /***********************************************************************
  * Gui block deleter is a mini-object that resides in the GUI thread
  * to handle the deletion of graphical blocks in the GUI context.
@@ -42,15 +52,48 @@ public slots:
     }
 };
 
+/***********************************************************************
+ * Gui status poster is a mini-object that resides in the GUI thread
+ * to apply the block status updates of an evaluation pass in the GUI
+ * context. The EvalEngineImpl sends one batch of updates per pass.
+ **********************************************************************/
+class EvalEngineGuiStatusPoster : public QObject
+{
+    Q_OBJECT
+public:
+    EvalEngineGuiStatusPoster(void)
+    {
+        qRegisterMetaType<BlockStatusUpdates>("BlockStatusUpdates");
+        this->moveToThread(QApplication::instance()->thread());
+    }
+
+public slots:
+    void handleStatusUpdates(const BlockStatusUpdates &updates)
+    {
+        for (const auto &update : updates) BlockEval::postStatusToBlock(update);
+    }
+};
+
 /***********************************************************************
  * Eval engine implementation
  **********************************************************************/
 EvalEngineImpl::EvalEngineImpl(EvalTracer &tracer):
     _requireEval(false),
+    _requireHealthCheck(false),
     _tracer(tracer),
     _monitorTimer(new QTimer(this)),
-    _guiBlockDeleter(new EvalEngineGuiBlockDeleter())
+    _workerPool(new QThreadPool(this)),
+    _envPool(new EnvironmentPool()),
+    _guiBlockDeleter(new EvalEngineGuiBlockDeleter()),
+    _guiStatusPoster(new EvalEngineGuiStatusPoster())
 {
+    _workerPool->setMaxThreadCount(MAX_WORKER_THREADS);
+
+    //keep the workers for the lifetime of the engine, each worker installs
+    //the tracer once and records into its own span stack across passes,
+    //an expired worker would leave its recorded stack behind in the tracer
+    _workerPool->setExpiryTimeout(-1);
+
     qRegisterMetaType<BlockInfo>("BlockInfo");
     qRegisterMetaType<BlockInfos>("BlockInfos");
     qRegisterMetaType<ConnectionInfo>("ConnectionInfo");
@@ -169,29 +212,34 @@ QByteArray EvalEngineImpl::getTopologyJSONStats(void)
     return QByteArray(stats.data(), stats.size());
 }
 
+QByteArray EvalEngineImpl::getEvalJSONStats(void)
+{
+    QJsonObject stats;
+    stats["numEvalPasses"] = double(_numEvalPasses);
+    stats["lastBlocksEvaluated"] = double(_lastBlocksEvaluated);
+    stats["lastBlocksSkipped"] = double(_lastBlocksSkipped);
+    stats["totalBlocksEvaluated"] = double(_totalBlocksEvaluated);
+    stats["totalBlocksSkipped"] = double(_totalBlocksSkipped);
+    return QJsonDocument(stats).toJson(QJsonDocument::Compact);
+}
+
 void EvalEngineImpl::handleMonitorTimeout(void)
 {
-    //cause periodic re-eval to deal with errors
-    _requireEval = true;
+    //cause periodic health check to deal with errors,
+    //blocks are only re-evaluated when their inputs changed
+    _requireHealthCheck = true;
     this->evaluate();
 }
 
-void EvalEngineImpl::evaluate(void)
+void EvalEngineImpl::mergeInfo(void)
 {
-    EvalTracer::install(_tracer); //needed here to install the tracer
     EVAL_TRACER_FUNC();
 
-    //Do not evaluate when there are pending events in the queue.
-    //Evaluate only after all events received - AKA event compression.
-    if (_lastRxInvokeCount != _invokeCount) return;
-
-    //Only evaluate if require evaluate was flagged by a slot
-    if (not _requireEval) return;
-    _requireEval = false;
-
     std::map<size_t, std::shared_ptr<BlockEval>> newBlockEvals;
     std::map<QString, std::shared_ptr<ThreadPoolEval>> newThreadPoolEvals;
     std::map<HostProcPair, std::shared_ptr<EnvironmentEval>> newEnvironmentEvals;
+    std::map<HostProcPair, EnvironmentPartition> newPartitionsByEnv;
+    std::map<std::string, EnvironmentPoolConfig> poolConfigs;
 
     //merge in the block info
     for (const auto &blockInfoPair : _blockInfo)
@@ -224,6 +272,8 @@ void EvalEngineImpl::evaluate(void)
             auto it = _threadPoolEvals.find(zone);
             if (it != _threadPoolEvals.end()) threadPoolEval = _threadPoolEvals.at(zone);
             else threadPoolEval.reset(new ThreadPoolEval());
+            newPartitionsByEnv[hostProcKey].threadPoolEvals.push_back(threadPoolEval);
+            EnvironmentEval::mergePoolConfig(zone, config, poolConfigs);
         }
 
         //copy the eval environment or make a new one
@@ -232,7 +282,8 @@ void EvalEngineImpl::evaluate(void)
         {
             auto it = _environmentEvals.find(hostProcKey);
             if (it != _environmentEvals.end()) envEval = it->second;
-            else envEval.reset(new EnvironmentEval());
+            else envEval.reset(new EnvironmentEval(_envPool));
+            newPartitionsByEnv[hostProcKey].envEval = envEval;
         }
 
         //pass config into the environment
@@ -249,42 +300,163 @@ void EvalEngineImpl::evaluate(void)
         blockEval->acceptInfo(blockInfo);
         blockEval->acceptThreadPool(threadPoolEval);
         blockEval->acceptEnvironment(envEval);
+
+        //partition by environment, preserving the order within
+        newPartitionsByEnv[hostProcKey].blockEvals.push_back(blockEval);
     }
 
     //swap in the latest engines that are in-use
     _blockEvals = newBlockEvals;
     _threadPoolEvals = newThreadPoolEvals;
     _environmentEvals = newEnvironmentEvals;
+    _partitionsByEnv = newPartitionsByEnv;
 
-    //0) disconnect any blocks that will be torn down below
-    if (_topologyEval) _topologyEval->disconnect();
-    //1) update all environments in case there were changes
-    for (auto &pair : _environmentEvals) pair.second->update();
-    //2) update all thread pools in case there were changes
-    for (auto &pair : _threadPoolEvals) pair.second->update();
-    //3) update all the blocks in case there were changes
-    for (auto &pair : _blockEvals)
+    //keep warm environments for the hosts in use, release the others
+    _envPool->setPoolConfigs(poolConfigs);
+}
+
+void EvalEngineImpl::updateEnvironmentPartitions(void)
+{
+    EVAL_TRACER_FUNC();
+    _lastBlocksEvaluated = 0;
+    _lastBlocksSkipped = 0;
+
+    //Each environment is a separate process or host,
+    //so the partitions are updated concurrently on workers:
+    //spawning new environments does not wait on other hosts,
+    //and blocks evaluate as soon as their environment is ready.
+    //The first partition is updated in this thread context.
+    QList<QFuture<size_t>> futures;
+    const EnvironmentPartition *localPartition = nullptr;
+    for (const auto &pair : _partitionsByEnv)
     {
-        auto &blockEval = pair.second;
-        blockEval->update();
+        if (localPartition == nullptr)
+        {
+            localPartition = &pair.second;
+            continue;
+        }
+        const auto &partition = pair.second;
+        futures.push_back(QtConcurrent::run(_workerPool, [this, &partition](void)
+        {
+            return this->updateEnvironmentPartition(partition);
+        }));
+    }
+    if (localPartition != nullptr) _lastBlocksEvaluated += this->updateEnvironmentPartition(*localPartition);
+
+    //join all of the workers before continuing
+    for (auto &future : futures) _lastBlocksEvaluated += future.result();
+    _lastBlocksSkipped = _blockEvals.size() - _lastBlocksEvaluated;
+
+    //track graphical blocks for deletion in the GUI context
+    for (const auto &pair : _blockEvals)
+    {
+        const auto &blockEval = pair.second;
         if (blockEval->isGraphWidget()) _guiBlocks.insert(blockEval->getProxyBlock().getHandle());
     }
-    //4) update topology when present (activation mode)
+
+    _numEvalPasses++;
+    _totalBlocksEvaluated += _lastBlocksEvaluated;
+    _totalBlocksSkipped += _lastBlocksSkipped;
+}
+
+size_t EvalEngineImpl::updateEnvironmentPartition(const EnvironmentPartition &partition)
+{
+    EvalTracer::install(_tracer); //needed for worker threads, once per thread
+
+    //1) update the environment in case there were changes
+    //health checks only record the block work, an idle pass would
+    //otherwise flood the phase windows with near zero samples
+    {
+        EvalMetricsTimer metricsTimer("environment update", _mergePass);
+        partition.envEval->update();
+    }
+
+    //2) update the thread pools in case there were changes
+    for (const auto &threadPoolEval : partition.threadPoolEvals)
+    {
+        EvalMetricsTimer metricsTimer("thread pool update", _mergePass);
+        threadPoolEval->update();
+    }
+
+    //3) update the blocks with changes since the last pass
+    size_t numEvaluated = 0;
+    std::vector<std::shared_ptr<BlockEval>> unchangedBlockEvals;
+    for (const auto &blockEval : partition.blockEvals)
+    {
+        if (blockEval->isUpdateRequired())
+        {
+            EvalMetricsTimer metricsTimer("block update");
+            blockEval->update();
+            numEvaluated++;
+        }
+        else unchangedBlockEvals.push_back(blockEval);
+    }
+
+    //refresh expired overlays of the unchanged blocks, batched when supported
+    BlockEval::updateOverlays(partition.envEval, unchangedBlockEvals);
+
+    //4) join graph widgets constructed in the gui thread during this pass,
+    //all widgets are queued before the first wait, so the gui thread builds
+    //them back to back while the blocks and overlays above are evaluated
+    for (const auto &blockEval : partition.blockEvals)
+    {
+        if (not blockEval->isUpdatePending()) continue;
+        EvalMetricsTimer metricsTimer("graph widget join");
+        blockEval->finishUpdate();
+    }
+    return numEvaluated;
+}
+
+void EvalEngineImpl::evaluate(void)
+{
+    EvalTracer::install(_tracer); //needed here to install the tracer
+    EVAL_TRACER_FUNC();
+
+    //Do not evaluate when there are pending events in the queue.
+    //Evaluate only after all events received - AKA event compression.
+    if (_lastRxInvokeCount != _invokeCount) return;
+
+    //Only evaluate if require evaluate was flagged by a slot
+    //or the monitor requested a health check of the environments
+    if (not _requireEval and not _requireHealthCheck) return;
+    EvalMetricsTimer metricsTimer(_requireEval?"evaluate":"health check");
+    const bool requireMerge = _requireEval;
+    _mergePass = requireMerge;
+    _requireEval = false;
+    _requireHealthCheck = false;
+
+    //merge in the latest information when submitted by a slot,
+    //a health check alone re-uses the evals from the last pass
+    if (requireMerge) this->mergeInfo();
+
+    //0) disconnect any blocks that will be torn down below
+    if (_topologyEval) _topologyEval->disconnect(requireMerge);
+    //1-3) update environments, thread pools, and blocks per environment
+    this->updateEnvironmentPartitions();
+    //4) update topology when present (activation mode), one commit per pass
     if (_topologyEval)
     {
         _topologyEval->acceptConnectionInfo(_connectionInfo);
         _topologyEval->acceptBlockEvals(_blockEvals);
-        _topologyEval->update();
+        _topologyEval->update(requireMerge);
+    }
 
-        //deactivate design in the face of certain failures
-        if (_topologyEval->isFailureState())
-        {
-            _topologyEval.reset();
-            _blockEvals.clear();
-            emit this->deactivateDesign();
-            //cause an immediate re-evaluation
-            invokeMethod("handleMonitorTimeout", Qt::QueuedConnection);
-        }
+    //5) deliver the status changes of this pass to the gui in one batch
+    this->postStatusUpdates();
+
+    //failed connections are rolled back in the topology eval,
+    //deactivate design when the last good state was not restored
+    if (_topologyEval and _topologyEval->isFailureState())
+    {
+        _topologyEval.reset();
+        _blockEvals.clear();
+        _partitionsByEnv.clear();
+        //the dropped blocks are in an unknown state, do not reuse them
+        for (const auto &pair : _environmentEvals) pair.second->getBlockInstanceCache().clear();
+        emit this->deactivateDesign();
+        //cause an immediate re-evaluation
+        _requireEval = true;
+        invokeMethod("handleMonitorTimeout", Qt::QueuedConnection);
     }
 
     this->handleOrphanedGuiBlocks();
@@ -300,6 +472,7 @@ void EvalEngineImpl::submitCleanup(void)
     //clear evals
     _topologyEval.reset();
     _blockEvals.clear();
+    _partitionsByEnv.clear();
     _threadPoolEvals.clear();
     _environmentEvals.clear();
 
@@ -307,6 +480,19 @@ void EvalEngineImpl::submitCleanup(void)
     _monitorTimer->stop();
 }
 
+void EvalEngineImpl::postStatusUpdates(void)
+{
+    BlockStatusUpdates updates;
+    for (const auto &pair : _blockEvals)
+    {
+        BlockStatusUpdate update;
+        if (pair.second->takeStatusUpdate(update)) updates.push_back(update);
+    }
+    if (updates.empty()) return;
+    QMetaObject::invokeMethod(_guiStatusPoster.get(), "handleStatusUpdates",
+        Qt::QueuedConnection, Q_ARG(BlockStatusUpdates, updates));
+}
+
 void EvalEngineImpl::handleOrphanedGuiBlocks(void)
 {
     for (auto it = _guiBlocks.begin(); it != _guiBlocks.end();)
@@ -13,15 +13,19 @@
 #include <utility>
 #include <map>
 #include <set>
+#include <vector>
 
 class EnvironmentEval;
+class EnvironmentPool;
 class ThreadPoolEval;
 class TopologyEval;
 class BlockEval;
 class GraphBlock;
 class EvalTracer;
 class QTimer;
+class QThreadPool;
 class EvalEngineGuiBlockDeleter;
+class EvalEngineGuiStatusPoster;
 
 typedef std::map<size_t, BlockInfo> BlockInfos;
 typedef std::map<QString, QJsonObject> ZoneInfos;
@@ -85,6 +89,9 @@ public slots:
     //! query the JSON stats for the active topology
     QByteArray getTopologyJSONStats(void);
 
+    //! query the JSON stats for the evaluator itself
+    QByteArray getEvalJSONStats(void);
+
     //! Cleanup and shutdown prior to destruction
     void submitCleanup(void);
 
@@ -97,8 +104,28 @@ private slots:
     }
 
 private:
+    void mergeInfo(void);
     void evaluate(void);
+    void updateEnvironmentPartitions(void);
+
+    //! The evals which depend upon a single environment
+    struct EnvironmentPartition
+    {
+        std::shared_ptr<EnvironmentEval> envEval;
+        std::vector<std::shared_ptr<ThreadPoolEval>> threadPoolEvals;
+        std::vector<std::shared_ptr<BlockEval>> blockEvals;
+    };
+    size_t updateEnvironmentPartition(const EnvironmentPartition &partition);
     bool _requireEval;
+    bool _requireHealthCheck;
+    bool _mergePass{false}; //the current pass merged new info (not a health check)
+
+    //incremental evaluation counters
+    size_t _numEvalPasses{0};
+    size_t _lastBlocksEvaluated{0};
+    size_t _lastBlocksSkipped{0};
+    size_t _totalBlocksEvaluated{0};
+    size_t _totalBlocksSkipped{0};
 
     //queued event tracking
     int _lastRxInvokeCount{0};
@@ -118,7 +145,18 @@ private:
     std::map<size_t, std::shared_ptr<BlockEval>> _blockEvals;
     std::shared_ptr<TopologyEval> _topologyEval;
 
+    //evals partitioned by environment for concurrent updates
+    std::map<HostProcPair, EnvironmentPartition> _partitionsByEnv;
+    QThreadPool *_workerPool;
+
+    //warm environments claimed by new environment evals
+    std::shared_ptr<EnvironmentPool> _envPool;
+
     void handleOrphanedGuiBlocks(void);
     std::set<std::shared_ptr<void>> _guiBlocks;
     std::shared_ptr<EvalEngineGuiBlockDeleter> _guiBlockDeleter;
+
+    //batched status delivery to the graph blocks
+    void postStatusUpdates(void);
+    std::shared_ptr<EvalEngineGuiStatusPoster> _guiStatusPoster;
 };
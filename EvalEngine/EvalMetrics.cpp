@@ -0,0 +1,67 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "EvalMetrics.hpp"
+#include <algorithm> //nth_element, max_element
+
+//! Number of latest samples kept per phase
+static const size_t ROLLING_WINDOW_SIZE = 1024;
+
+EvalMetrics &EvalMetrics::global(void)
+{
+    static EvalMetrics metrics;
+    return metrics;
+}
+
+EvalMetrics::EvalMetrics(void)
+{
+    return;
+}
+
+void EvalMetrics::record(const std::string &phase, const std::chrono::nanoseconds &latency)
+{
+    const double ms = latency.count()/1e6;
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto &window = _windows[phase];
+    if (window.samplesMs.size() < ROLLING_WINDOW_SIZE) window.samplesMs.push_back(ms);
+    else window.samplesMs[window.next] = ms;
+    window.next = (window.next+1) % ROLLING_WINDOW_SIZE;
+    window.count++;
+}
+
+void EvalMetrics::reset(void)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _windows.clear();
+}
+
+static double percentile(std::vector<double> &samples, const double p)
+{
+    const auto index = size_t(p*(samples.size()-1));
+    std::nth_element(samples.begin(), samples.begin()+index, samples.end());
+    return samples[index];
+}
+
+QJsonObject EvalMetrics::toJSON(void) const
+{
+    //copy the windows to avoid sorting while holding the lock
+    std::map<std::string, Window> windows;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        windows = _windows;
+    }
+
+    QJsonObject topObj;
+    for (auto &pair : windows)
+    {
+        auto &samples = pair.second.samplesMs;
+        if (samples.empty()) continue;
+        QJsonObject phaseObj;
+        phaseObj["count"] = double(pair.second.count);
+        phaseObj["maxMs"] = *std::max_element(samples.begin(), samples.end());
+        phaseObj["p99Ms"] = percentile(samples, 0.99);
+        phaseObj["p50Ms"] = percentile(samples, 0.50);
+        topObj[QString::fromStdString(pair.first)] = phaseObj;
+    }
+    return topObj;
+}
@@ -0,0 +1,77 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Config.hpp>
+#include <QJsonObject>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <map>
+
+/*!
+ * Eval metrics keeps rolling latency windows for the phases of evaluation.
+ * Samples are recorded from the eval thread, worker threads, and the GUI
+ * thread, and summarized as p50, p99, and max over the latest samples.
+ * The metrics are global so that all graph editors report to one panel.
+ */
+class EvalMetrics
+{
+public:
+
+    //! Get access to the global metrics
+    static EvalMetrics &global(void);
+
+    EvalMetrics(void);
+
+    //! Record a latency sample for the named phase
+    void record(const std::string &phase, const std::chrono::nanoseconds &latency);
+
+    //! Clear all recorded samples
+    void reset(void);
+
+    /*!
+     * Summarize the rolling windows as a JSON object:
+     * phase name -> {count, p50Ms, p99Ms, maxMs}
+     */
+    QJsonObject toJSON(void) const;
+
+private:
+    struct Window
+    {
+        std::vector<double> samplesMs;
+        size_t next{0};
+        size_t count{0};
+    };
+    mutable std::mutex _mutex;
+    std::map<std::string, Window> _windows;
+};
+
+/*!
+ * Record the duration of a scope into the global eval metrics.
+ * A disabled timer records nothing, used to keep cheap passes
+ * from diluting the samples of a phase.
+ */
+class EvalMetricsTimer
+{
+public:
+    EvalMetricsTimer(const char *phase, const bool enabled = true):
+        _phase(phase),
+        _enabled(enabled),
+        _start(std::chrono::steady_clock::now())
+    {
+        return;
+    }
+
+    ~EvalMetricsTimer(void)
+    {
+        if (not _enabled) return;
+        EvalMetrics::global().record(_phase, std::chrono::steady_clock::now() - _start);
+    }
+
+private:
+    const char *_phase;
+    const bool _enabled;
+    const std::chrono::steady_clock::time_point _start;
+};
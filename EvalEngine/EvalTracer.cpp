@@ -1,58 +1,217 @@
-// Copyright (c) 2017-2017 Josh Blum
+// Copyright (c) 2017-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #include "EvalTracer.hpp"
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QFileInfo>
+#include <algorithm> //min
 
-EvalTracer::EvalTracer(void)
+//! Number of completed spans recorded per thread
+static const size_t RING_BUFFER_SIZE = 4096;
+
+/***********************************************************************
+ * Per-thread span storage
+ **********************************************************************/
+struct EvalTraceSpan
 {
-    return;
-}
+    const char *name;
+    const char *file;
+    int line;
+    QString arg;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point stop;
+};
 
-QString EvalTracer::trace(void) const
+class EvalTraceThread
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    QString out;
-    QString indent;
-    for (const auto &elem : _stack)
+public:
+    EvalTraceThread(const int threadId):
+        threadId(threadId),
+        ringNext(0),
+        ringCount(0)
     {
-        if (not out.isEmpty()) out += "\n" + indent;
-        out += elem;
-        indent += "  ";
+        return;
     }
-    return out;
+
+    //the mutex is only contended when another thread reads the trace
+    std::mutex mutex;
+    const int threadId;
+    std::vector<EvalTraceSpan> stack;
+    std::vector<EvalTraceSpan> ring;
+    size_t ringNext;
+    size_t ringCount;
+};
+
+/***********************************************************************
+ * Thread local installation
+ **********************************************************************/
+struct EvalTracerLocal
+{
+    EvalTracer *tracer{nullptr};
+    size_t tracerId{0};
+    std::shared_ptr<EvalTraceThread> thread;
+};
+
+static thread_local EvalTracerLocal __tls_tracer;
+
+static size_t nextTracerId(void)
+{
+    static std::atomic<size_t> id(0);
+    return ++id;
+}
+
+void EvalTracer::install(EvalTracer &tracer)
+{
+    if (__tls_tracer.tracerId == tracer._id) return;
+    __tls_tracer.tracer = &tracer;
+    __tls_tracer.tracerId = tracer._id;
+    __tls_tracer.thread = tracer.registerThread();
 }
 
-void EvalTracer::push(const QString &pos)
+EvalTracer &EvalTracer::getGlobal(void)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    _stack.push_back(pos);
+    return *__tls_tracer.tracer;
 }
 
-void EvalTracer::pop(void)
+/***********************************************************************
+ * Eval tracer implementation
+ **********************************************************************/
+EvalTracer::EvalTracer(void):
+    _id(nextTracerId()),
+    _epoch(std::chrono::steady_clock::now()),
+    _recording(false),
+    _nextThreadId(0)
+{
+    return;
+}
+
+EvalTracer::~EvalTracer(void)
+{
+    return;
+}
+
+std::shared_ptr<EvalTraceThread> EvalTracer::registerThread(void)
 {
     std::lock_guard<std::mutex> lock(_mutex);
-    _stack.pop_back();
+
+    //prune threads that exited without recorded spans
+    for (auto it = _threads.begin(); it != _threads.end();)
+    {
+        if (it->unique() and (*it)->ringCount == 0) it = _threads.erase(it);
+        else it++;
+    }
+
+    std::shared_ptr<EvalTraceThread> thread(new EvalTraceThread(_nextThreadId++));
+    _threads.push_back(thread);
+    return thread;
 }
 
-static thread_local EvalTracer *__tls_tracer(nullptr);
+void EvalTracer::push(const char *name, const char *file, const int line, const QString &arg)
+{
+    auto &thread = *__tls_tracer.thread;
+    std::lock_guard<std::mutex> lock(thread.mutex);
+    EvalTraceSpan span;
+    span.name = name;
+    span.file = file;
+    span.line = line;
+    span.arg = arg;
+    span.start = std::chrono::steady_clock::now();
+    thread.stack.push_back(std::move(span));
+}
 
-void EvalTracer::install(EvalTracer &tracer)
+void EvalTracer::pop(void)
 {
-    __tls_tracer = &tracer;
+    auto &thread = *__tls_tracer.thread;
+    std::lock_guard<std::mutex> lock(thread.mutex);
+    if (this->isRecording())
+    {
+        auto &span = thread.stack.back();
+        span.stop = std::chrono::steady_clock::now();
+        if (thread.ring.size() != RING_BUFFER_SIZE) thread.ring.resize(RING_BUFFER_SIZE);
+        thread.ring[thread.ringNext] = std::move(span);
+        thread.ringNext = (thread.ringNext+1) % RING_BUFFER_SIZE;
+        thread.ringCount = std::min(thread.ringCount+1, RING_BUFFER_SIZE);
+    }
+    thread.stack.pop_back();
 }
 
-EvalTracer &EvalTracer::getGlobal(void)
+void EvalTracer::setRecording(const bool enable)
 {
-    return *__tls_tracer;
+    _recording.store(enable, std::memory_order_relaxed);
+    if (enable) return;
+
+    //release the recorded spans when recording stops
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto &thread : _threads)
+    {
+        std::lock_guard<std::mutex> threadLock(thread->mutex);
+        thread->ring.clear();
+        thread->ringNext = 0;
+        thread->ringCount = 0;
+    }
 }
 
-EvalTraceEntry::EvalTraceEntry(EvalTracer &stack, const QString &what):
-    _stack(stack)
+QString EvalTracer::trace(void) const
 {
-    _stack.push(what);
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(_mutex);
+    QString out;
+    for (const auto &thread : _threads)
+    {
+        std::lock_guard<std::mutex> threadLock(thread->mutex);
+        if (thread->stack.empty()) continue;
+        if (not out.isEmpty()) out += "\n";
+        out += QString("thread %1:").arg(thread->threadId);
+        QString indent("  ");
+        for (const auto &span : thread->stack)
+        {
+            const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - span.start);
+            out += QString("\n%1%2:%3 %4").arg(indent).arg(QFileInfo(span.file).fileName()).arg(span.line).arg(span.name);
+            if (not span.arg.isEmpty()) out += QString(" [%1]").arg(span.arg);
+            out += QString(" (%1 ms)").arg(elapsed.count());
+            indent += "  ";
+        }
+    }
+    return out;
 }
 
-EvalTraceEntry::~EvalTraceEntry(void)
+QByteArray EvalTracer::toChromeTrace(void) const
 {
-    _stack.pop();
+    const auto toUs = [this](const std::chrono::steady_clock::time_point &t)
+    {
+        return double(std::chrono::duration_cast<std::chrono::nanoseconds>(t - _epoch).count())/1e3;
+    };
+
+    QJsonArray events;
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto &thread : _threads)
+    {
+        std::lock_guard<std::mutex> threadLock(thread->mutex);
+        for (size_t i = 0; i < thread->ringCount; i++)
+        {
+            //iterate from the oldest span in the ring
+            const auto index = (thread->ringNext + RING_BUFFER_SIZE - thread->ringCount + i) % RING_BUFFER_SIZE;
+            const auto &span = thread->ring[index];
+            QJsonObject args;
+            args["location"] = QString("%1:%2").arg(QFileInfo(span.file).fileName()).arg(span.line);
+            if (not span.arg.isEmpty()) args["arg"] = span.arg;
+            QJsonObject event;
+            event["name"] = QString(span.name);
+            event["cat"] = "eval";
+            event["ph"] = "X";
+            event["ts"] = toUs(span.start);
+            event["dur"] = toUs(span.stop) - toUs(span.start);
+            event["pid"] = 0;
+            event["tid"] = thread->threadId;
+            event["args"] = args;
+            events.push_back(event);
+        }
+    }
+
+    QJsonObject topObj;
+    topObj["traceEvents"] = events;
+    topObj["displayTimeUnit"] = "ms";
+    return QJsonDocument(topObj).toJson(QJsonDocument::Compact);
 }
@@ -1,29 +1,54 @@
-// Copyright (c) 2017-2017 Josh Blum
+// Copyright (c) 2017-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #pragma once
 #include <Pothos/Config.hpp>
+#include <QByteArray>
 #include <QString>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <mutex>
-#include <deque>
-#include <QFileInfo>
+#include <vector>
 #include <QtGlobal> //Q_FUNC_INFO
 
-//! The eval tracer keeps track of a stack (thread safe)
+class EvalTraceThread;
+
+/*!
+ * The eval tracer keeps a stack of timed spans per thread.
+ * Spans are identified by static string literals and an optional argument,
+ * so entering a span does not format strings or contend on a shared lock.
+ * When recording is enabled, completed spans are kept in a per-thread
+ * ring buffer which can be exported as Chrome trace-event JSON.
+ */
 class EvalTracer
 {
 public:
     EvalTracer(void);
 
-    //! Get a formated printable string
+    ~EvalTracer(void);
+
+    //! Get a formated printable string of the active spans in all threads
     QString trace(void) const;
 
-    //! Push a new position onto the top of the stack
-    void push(const QString &what);
+    //! Push a new span onto the top of this thread's stack
+    void push(const char *name, const char *file, const int line, const QString &arg);
 
-    //! Remove the element from the top of the stack
+    //! Remove the span from the top of this thread's stack
     void pop(void);
 
+    //! Enable or disable recording of completed spans
+    void setRecording(const bool enable);
+
+    //! Are completed spans being recorded?
+    bool isRecording(void) const
+    {
+        return _recording.load(std::memory_order_relaxed);
+    }
+
+    //! Export the recorded spans as Chrome trace-event JSON
+    QByteArray toChromeTrace(void) const;
+
     //! Set the local thread context's tracer
     static void install(EvalTracer &tracer);
 
@@ -34,34 +59,50 @@ public:
     static EvalTracer &getGlobal(void);
 
 private:
+    std::shared_ptr<EvalTraceThread> registerThread(void);
+
+    const size_t _id;
+    const std::chrono::steady_clock::time_point _epoch;
+    std::atomic<bool> _recording;
     mutable std::mutex _mutex;
-    std::deque<QString> _stack;
+    std::vector<std::shared_ptr<EvalTraceThread>> _threads;
+    int _nextThreadId;
 };
 
 //! Create an entry in the tracer that cleans itself up
 class EvalTraceEntry
 {
 public:
-    EvalTraceEntry(EvalTracer &stack, const QString &what);
+    EvalTraceEntry(EvalTracer &tracer, const char *name, const char *file, const int line, const QString &arg = QString()):
+        _tracer(tracer)
+    {
+        _tracer.push(name, file, line, arg);
+    }
 
-    ~EvalTraceEntry(void);
+    ~EvalTraceEntry(void)
+    {
+        _tracer.pop();
+    }
 
 private:
-    EvalTracer &_stack;
+    EvalTracer &_tracer;
 };
 
 #define __CONCAT_IMPL( x, y ) x##y
 #define __MACRO_CONCAT( x, y ) __CONCAT_IMPL( x, y )
 
-//! Create an entry in the tracer for an arbitrary action
-#define EVAL_TRACER_ACTION(a) EvalTraceEntry \
+//! Create an entry in the tracer for an action named by a string literal
+#define EVAL_TRACER_ACTION(name) EvalTraceEntry \
+    __MACRO_CONCAT(__evalTraceEntry, __COUNTER__)( \
+        EvalTracer::getGlobal(), name, __FILE__, __LINE__)
+
+//! Create an entry in the tracer for an action with an identifying argument
+#define EVAL_TRACER_ACTION_ARG(name, arg) EvalTraceEntry \
     __MACRO_CONCAT(__evalTraceEntry, __COUNTER__)( \
-        EvalTracer::getGlobal(), QString("%1:%2 %3") \
-        .arg(QFileInfo(__FILE__).fileName()).arg(__LINE__).arg(a))
+        EvalTracer::getGlobal(), name, __FILE__, __LINE__, arg)
 
 //! Create an entry in the tracer for entering a function
 #define EVAL_TRACER_FUNC() EVAL_TRACER_ACTION(Q_FUNC_INFO)
 
 //! Provide an extra argument that identifies the object
-#define EVAL_TRACER_FUNC_ARG(what) \
-    EVAL_TRACER_ACTION(QString("%1 [%2]").arg(Q_FUNC_INFO).arg(what))
+#define EVAL_TRACER_FUNC_ARG(what) EVAL_TRACER_ACTION_ARG(Q_FUNC_INFO, what)
@@ -1,4 +1,4 @@
-// Copyright (c) 2014-2017 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #include "ThreadPoolEval.hpp"
@@ -9,6 +9,28 @@
 #include <Poco/Logger.h>
 #include <QJsonDocument>
 
+/*!
+ * Zone config keys that do not configure the thread pool:
+ * The display color, and the keys that select or tune the
+ * evaluation environment, which are handled by the EnvironmentEval.
+ */
+static const char *NON_RUNTIME_ZONE_KEYS[] = {
+    "color",
+    "hostUri",
+    "processName",
+    "heartbeatIntervalMs",
+    "environmentPoolSize",
+    "spawnTimeoutMs",
+};
+
+//! Strip a zone config down to the thread pool arguments
+static QJsonObject getRuntimeConfig(const QJsonObject &config)
+{
+    auto runtimeConfig = config;
+    for (const auto key : NON_RUNTIME_ZONE_KEYS) runtimeConfig.remove(key);
+    return runtimeConfig;
+}
+
 ThreadPoolEval::ThreadPoolEval(void):
     _failureState(false)
 {
@@ -22,7 +44,7 @@ ThreadPoolEval::~ThreadPoolEval(void)
 
 void ThreadPoolEval::acceptConfig(const QJsonObject &config)
 {
-    _newZoneConfig = config;
+    _newZoneConfig = getRuntimeConfig(config);
 }
 
 void ThreadPoolEval::acceptEnvironment(const std::shared_ptr<EnvironmentEval> &env)
@@ -61,7 +83,10 @@ void ThreadPoolEval::update(void)
     bool requireNewThreadPool = _newEnvironment != _lastEnvironment;
 
     //zone configuration change?
-    //a config change of any kind means a new thread pool
+    //only the thread pool arguments are tracked, so cosmetic edits
+    //like the zone color never rebuild the pool or touch the blocks;
+    //there is no API to re-configure a running pool in place,
+    //so a change to any of the arguments means a new thread pool
     if (_newZoneConfig != _lastZoneConfig)
     {
         requireNewThreadPool = true;
@@ -1,4 +1,4 @@
-// Copyright (c) 2014-2017 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #pragma once
@@ -25,6 +25,7 @@ public:
     /*!
      * Called under re-eval to apply the latest config.
      * This call should take the info and not process.
+     * Only the thread pool arguments of the zone are kept.
      */
     void acceptConfig(const QJsonObject &config);
 
@@ -72,6 +73,7 @@ private:
 
     //Tracking state for the thread pool configuration.
     //A change in config merritts making a new thread pool.
+    //The cosmetic and environment keys are stripped on accept.
     QJsonObject _newZoneConfig;
     QJsonObject _lastZoneConfig;
 
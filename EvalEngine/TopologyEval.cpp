@@ -1,15 +1,17 @@
-// Copyright (c) 2014-2017 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #include "TopologyEval.hpp"
 #include "BlockEval.hpp"
 #include "EvalTracer.hpp"
+#include "EvalMetrics.hpp"
 #include <Pothos/Framework.hpp>
-#include <algorithm> //std::remove
+#include <set>
 #include <iostream>
 
 TopologyEval::TopologyEval(void):
     _topology(new Pothos::Topology()),
+    _commitRequired(false),
     _failureState(false),
     _logger(Poco::Logger::get("PothosFlow.TopologyEval"))
 {
@@ -31,13 +33,33 @@ void TopologyEval::acceptBlockEvals(const std::map<size_t, std::shared_ptr<Block
     _newBlockEvals = info;
 }
 
-void TopologyEval::disconnect(void)
+void TopologyEval::disconnect(const bool recordMetrics)
 {
     EVAL_TRACER_FUNC();
+    EvalMetricsTimer metricsTimer("topology disconnect", recordMetrics);
     if (this->isFailureState()) return;
 
-    const auto connsCopy = _currentConnections;
-    for (const auto &conn : connsCopy)
+    //query each block once for blocks that specify that they should disconnect
+    std::set<size_t> disconnectUIDs;
+    bool reconstruct = false;
+    for (const auto &pair : _lastBlockEvals)
+    {
+        if (not pair.second->shouldDisconnect()) continue;
+        disconnectUIDs.insert(pair.first);
+        if (pair.second->shouldReconstruct()) reconstruct = true;
+    }
+    if (disconnectUIDs.empty()) return; //nothing to do
+
+    //collect the connections that involve the disconnecting blocks
+    std::vector<ConnectionInfo> disconnects;
+    for (const auto &conn : _currentConnections)
+    {
+        if (disconnectUIDs.count(conn.srcBlockUID) != 0 or
+            disconnectUIDs.count(conn.dstBlockUID) != 0) disconnects.push_back(conn);
+    }
+    if (disconnects.empty()) return; //nothing to do
+
+    for (const auto &conn : disconnects)
     {
         //locate the src and dst block evals
         assert(_lastBlockEvals.count(conn.srcBlockUID) != 0);
@@ -45,37 +67,50 @@ void TopologyEval::disconnect(void)
         auto src = _lastBlockEvals.at(conn.srcBlockUID);
         auto dst = _lastBlockEvals.at(conn.dstBlockUID);
 
-        //only blocks that specify that they should disconnect
-        if (src->shouldDisconnect() or dst->shouldDisconnect())
+        try
         {
-            try
-            {
-                _topology->disconnect(
-                    src->getProxyBlock(), conn.srcPort.toStdString(),
-                    dst->getProxyBlock(), conn.dstPort.toStdString());
-                _currentConnections.remove(conn);
-            }
-            catch (const Pothos::Exception &ex)
-            {
-                _logger.error("Failed to disconnect: %s", ex.displayText());
-                _failureState = true;
-                return;
-            }
+            _topology->disconnect(
+                src->getProxyBlock(), conn.srcPort.toStdString(),
+                dst->getProxyBlock(), conn.dstPort.toStdString());
+            _commitRequired = true;
         }
+        catch (const Pothos::Exception &ex)
+        {
+            //the block is torn down regardless, forget the connection
+            _logger.error("Failed to disconnect %s: %s", conn.toString().toStdString(), ex.displayText());
+        }
+        _currentConnections.remove(conn);
+    }
+
+    //a replacement block may need the exclusive resources of the old block,
+    //such as a device handle, so the old block must leave the flow first.
+    //Known limit: this pass costs two commits, and the flow stays partially
+    //disconnected until update() connects the replacement block.
+    if (reconstruct)
+    {
+        if (_commitRequired and not this->commit()) _failureState = true;
+        return;
     }
 
-    //commit after changes
-    this->commit();
+    //otherwise the disconnects remain staged until the commit in update(),
+    //the old blocks keep running until they are swapped out at once
 }
 
-void TopologyEval::update(void)
+void TopologyEval::update(const bool recordMetrics)
 {
     EVAL_TRACER_FUNC();
+    EvalMetricsTimer metricsTimer("topology update", recordMetrics);
     if (this->isFailureState()) return;
 
     const auto removedConnections = diffConnectionInfos(_currentConnections, _newConnectionInfo);
     const auto addedConnections = diffConnectionInfos(_newConnectionInfo, _currentConnections);
-    if ((removedConnections.size() + addedConnections.size()) == 0) return; //nothing to do
+    if ((removedConnections.size() + addedConnections.size()) == 0)
+    {
+        //nothing to do, except for disconnects staged by disconnect()
+        if (_commitRequired and not this->commit()) _failureState = true;
+        this->postConnectionErrors();
+        return;
+    }
 
     //remove connections from the topology
     for (const auto &conn : removedConnections)
@@ -94,23 +129,24 @@ void TopologyEval::update(void)
         if (not src->portExists(conn.srcPort, false)) continue;
         if (not dst->portExists(conn.dstPort, true)) continue;
 
-        //attempt to remove the connection
+        //attempt to remove the connection,
+        //a failure means that the flow is not in the topology
         try
         {
             _topology->disconnect(
                 src->getProxyBlock(), conn.srcPort.toStdString(),
                 dst->getProxyBlock(), conn.dstPort.toStdString());
-            _currentConnections.remove(conn);
+            _commitRequired = true;
         }
         catch (const Pothos::Exception &ex)
         {
-            _logger.error("Failed to disconnect: %s", ex.displayText());
-            _failureState = true;
-            return;
+            _logger.error("Failed to disconnect %s: %s", conn.toString().toStdString(), ex.displayText());
         }
+        _currentConnections.remove(conn);
     }
 
     //create new connections
+    std::vector<ConnectionInfo> connected;
     for (const auto &conn : addedConnections)
     {
         //locate the src and dst block evals
@@ -127,24 +163,39 @@ void TopologyEval::update(void)
         if (not src->portExists(conn.srcPort, false)) continue;
         if (not dst->portExists(conn.dstPort, true)) continue;
 
-        //attempt to create the connection
+        //a failed connection stays in error until the info, environment,
+        //or thread pool of an endpoint changed and the block was updated
+        auto failedIt = _failedConnections.find(conn);
+        if (failedIt != _failedConnections.end())
+        {
+            if (failedIt->second.srcGeneration == src->getUpdateGeneration() and
+                failedIt->second.dstGeneration == dst->getUpdateGeneration()) continue;
+            _failedConnections.erase(failedIt);
+        }
+
+        //attempt to create the connection,
+        //a failure only puts the blocks of this connection into error
         try
         {
             _topology->connect(
                 src->getProxyBlock(), conn.srcPort.toStdString(),
                 dst->getProxyBlock(), conn.dstPort.toStdString());
             _currentConnections.insert(conn);
+            connected.push_back(conn);
+            src->markActivated();
+            dst->markActivated();
+            _commitRequired = true;
         }
         catch (const Pothos::Exception &ex)
         {
-            _logger.error("Failed to connect: %s", ex.displayText());
-            _failureState = true;
-            return;
+            _logger.error("Failed to connect %s: %s", conn.toString().toStdString(), ex.displayText());
+            this->reportConnectionError(conn, tr("Failed to connect: %1").arg(QString::fromStdString(ex.message())));
         }
     }
 
-    //commit after changes
-    this->commit();
+    //commit the staged disconnects and connects as a single change,
+    //on failure roll back the new connections and keep the rest running
+    if (_commitRequired and not this->commit()) this->rollback(connected);
 
     //stash data for the current state
     if (not _failureState)
@@ -152,61 +203,101 @@ void TopologyEval::update(void)
         _lastBlockEvals = _newBlockEvals;
         _lastConnectionInfo = _newConnectionInfo;
     }
+    this->postConnectionErrors();
 }
 
-void TopologyEval::commit(void)
+bool TopologyEval::commit(void)
 {
     EVAL_TRACER_FUNC();
+    EvalMetricsTimer metricsTimer("topology commit");
+    _commitRequired = false;
     try
     {
         _topology->commit();
+        return true;
     }
     catch (const Pothos::Exception &ex)
     {
         _logger.error("Failed to commit: %s", ex.displayText());
-        _failureState = true;
+        _commitErrorMsg = QString::fromStdString(ex.message());
+        return false;
     }
 }
 
-QString ConnectionInfo::toString(void) const
-{
-    return QString("%1[%2]->%3[%4]")
-        .arg(srcBlockUID).arg(srcPort)
-        .arg(dstBlockUID).arg(dstPort);
-}
-
-bool operator==(const ConnectionInfo &lhs, const ConnectionInfo &rhs)
+void TopologyEval::rollback(const std::vector<ConnectionInfo> &connected)
 {
-    return
-        (lhs.srcBlockUID == rhs.srcBlockUID) and
-        (lhs.dstBlockUID == rhs.dstBlockUID) and
-        (lhs.srcPort == rhs.srcPort) and
-        (lhs.dstPort == rhs.dstPort);
-}
+    EVAL_TRACER_FUNC();
 
-ConnectionInfos diffConnectionInfos(const ConnectionInfos &in0, const ConnectionInfos &in1)
-{
-    ConnectionInfos out;
-    for (const auto &elem0 : in0)
+    //undo the connections made in this pass,
+    //the staged disconnects only shrink the design and are kept
+    for (const auto &conn : connected)
     {
-        for (const auto &elem1 : in1)
+        auto src = _newBlockEvals.at(conn.srcBlockUID);
+        auto dst = _newBlockEvals.at(conn.dstBlockUID);
+        try
         {
-            if (elem0 == elem1) goto next_elem0;
+            _topology->disconnect(
+                src->getProxyBlock(), conn.srcPort.toStdString(),
+                dst->getProxyBlock(), conn.dstPort.toStdString());
+            _currentConnections.remove(conn);
+        }
+        catch (const Pothos::Exception &ex)
+        {
+            _logger.error("Failed to roll back %s: %s", conn.toString().toStdString(), ex.displayText());
+            _failureState = true;
+            return;
         }
-        out.push_back(elem0);
-        next_elem0: continue;
     }
-    return out;
+
+    //the previous design could not be restored, tear it down
+    const auto errorMsg = _commitErrorMsg;
+    if (not this->commit())
+    {
+        _failureState = true;
+        return;
+    }
+
+    //put the failed connections into error,
+    //so they are not connected again until a block is re-evaluated
+    _logger.warning("Rolled back %d new connections after a failed commit", int(connected.size()));
+    for (const auto &conn : connected)
+    {
+        this->reportConnectionError(conn, tr("Failed to commit: %1").arg(errorMsg));
+    }
 }
 
-void ConnectionInfos::insert(const ConnectionInfo &info)
+void TopologyEval::reportConnectionError(const ConnectionInfo &conn, const QString &errorMsg)
 {
-    this->remove(info); //remove all instances
-    this->push_back(info);
+    auto src = _newBlockEvals.at(conn.srcBlockUID);
+    auto dst = _newBlockEvals.at(conn.dstBlockUID);
+    auto &failed = _failedConnections[conn];
+    failed.srcGeneration = src->getUpdateGeneration();
+    failed.dstGeneration = dst->getUpdateGeneration();
+    failed.srcErrorMsg = tr("Output %1 to %2[%3]: %4").arg(conn.srcPort).arg(dst->getBlockId()).arg(conn.dstPort).arg(errorMsg);
+    failed.dstErrorMsg = tr("Input %1 from %2[%3]: %4").arg(conn.dstPort).arg(src->getBlockId()).arg(conn.srcPort).arg(errorMsg);
 }
 
-void ConnectionInfos::remove(const ConnectionInfo &info)
+void TopologyEval::postConnectionErrors(void)
 {
-    auto newEnd = std::remove(this->begin(), this->end(), info);
-    this->erase(newEnd, this->end());
+    //gather the errors per block, forget connections removed from the design
+    std::map<size_t, QStringList> errorMsgs;
+    for (auto it = _failedConnections.begin(); it != _failedConnections.end();)
+    {
+        if (not _newConnectionInfo.contains(it->first))
+        {
+            it = _failedConnections.erase(it);
+            continue;
+        }
+        errorMsgs[it->first.srcBlockUID].push_back(it->second.srcErrorMsg);
+        errorMsgs[it->first.dstBlockUID].push_back(it->second.dstErrorMsg);
+        ++it;
+    }
+    for (auto &pair : errorMsgs) pair.second.sort(); //stable order between passes
+
+    //blocks without an entry have their old connection errors cleared
+    for (const auto &pair : _newBlockEvals)
+    {
+        auto it = errorMsgs.find(pair.first);
+        pair.second->setConnectionErrors((it == errorMsgs.end())?QStringList():it->second);
+    }
 }
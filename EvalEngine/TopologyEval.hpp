@@ -1,15 +1,17 @@
-// Copyright (c) 2014-2017 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #pragma once
 #include <Pothos/Config.hpp>
 #include "GraphObjects/GraphObject.hpp"
+#include "ConnectionInfo.hpp"
 #include <Pothos/Proxy/Proxy.hpp>
 #include <QObject>
 #include <QString>
 #include <vector>
 #include <memory>
 #include <map>
+#include <unordered_map>
 #include <Poco/Logger.h>
 
 class BlockEval;
@@ -19,33 +21,6 @@ namespace Pothos
     class Topology;
 }
 
-/*!
- * Information about a connection between src and dst ports.
- * This is everything important we need to know about connections,
- * but extracted so we can access it in a thread-safe manner.
- */
-struct ConnectionInfo
-{
-    ConnectionInfo(void):
-        srcBlockUID(0),
-        dstBlockUID(0){}
-    size_t srcBlockUID, dstBlockUID;
-    QString srcPort, dstPort;
-    QString toString(void) const;
-};
-
-bool operator==(const ConnectionInfo &lhs, const ConnectionInfo &rhs);
-
-//! overload for multiple connection informations
-struct ConnectionInfos : std::vector<ConnectionInfo>
-{
-    void insert(const ConnectionInfo &info);
-    void remove(const ConnectionInfo &info);
-};
-
-//! Calculates set(in0 - in1)
-ConnectionInfos diffConnectionInfos(const ConnectionInfos &in0, const ConnectionInfos &in1);
-
 /*!
  * TopologyEval takes up to date connection information
  * and creates topology connections between block objects.
@@ -73,19 +48,28 @@ public:
     void acceptBlockEvals(const std::map<size_t, std::shared_ptr<BlockEval>> &);
 
     /*!
-     * Disconnect any connections that involve shouldDisconnect() blocks
+     * Disconnect any connections that involve shouldDisconnect() blocks.
+     * The disconnects are committed right away when a block will be
+     * constructed again, otherwise they are staged for the commit in update().
+     * So a pass that re-constructs a block, because of an environment or
+     * critical argument change, still takes two commits.
+     * \param recordMetrics false to skip the latency sample (health checks)
      */
-    void disconnect(void);
+    void disconnect(const bool recordMetrics);
 
     /*!
      * Perform update work after changes applied.
+     * Stage the connection changes and commit once per evaluation pass,
+     * along with any disconnects that are still staged.
+     * \param recordMetrics false to skip the latency sample (health checks)
      */
-    void update(void);
+    void update(const bool recordMetrics);
 
     /*!
      * Commit after changes with error handling
+     * \return true for success, false when the commit threw
      */
-    void commit(void);
+    bool commit(void);
 
     //! Get access to the active topology
     Pothos::Topology *getTopology(void) const
@@ -93,13 +77,27 @@ public:
         return _topology;
     }
 
-    //! An error caused the topology to go into failure state
+    /*!
+     * An error caused the topology to go into failure state.
+     * Failed connections and commits are rolled back first,
+     * this is only set when the design could not be restored.
+     */
     bool isFailureState(void) const
     {
         return _failureState;
     }
 
 private:
+
+    //! Undo the new connections after a failed commit and commit again
+    void rollback(const std::vector<ConnectionInfo> &connected);
+
+    //! Record a failed connection with the update generation of its blocks
+    void reportConnectionError(const ConnectionInfo &conn, const QString &errorMsg);
+
+    //! Forget failed connections no longer in the design and post the errors to the blocks
+    void postConnectionErrors(void);
+
     ConnectionInfos _newConnectionInfo;
     ConnectionInfos _lastConnectionInfo;
 
@@ -110,6 +108,18 @@ private:
     Pothos::Topology *_topology;
     ConnectionInfos _currentConnections;
 
+    //! Failed connections are not tried again until an endpoint is updated
+    struct FailedConnection
+    {
+        size_t srcGeneration, dstGeneration;
+        QString srcErrorMsg, dstErrorMsg;
+    };
+    std::unordered_map<ConnectionInfo, FailedConnection, ConnectionInfoHash> _failedConnections;
+
+    //! Staged changes are waiting for a commit
+    bool _commitRequired;
+    QString _commitErrorMsg;
+
     bool _failureState;
     Poco::Logger &_logger;
 };
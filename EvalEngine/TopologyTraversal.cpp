@@ -1,27 +1,59 @@
-// Copyright (c) 2014-2018 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #include "TopologyEval.hpp"
 #include "GraphObjects/GraphBlock.hpp"
 #include "GraphObjects/GraphBreaker.hpp"
 #include "GraphObjects/GraphConnection.hpp"
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <map>
+
+/*!
+ * A one-shot index of the graph objects for resolving breakers:
+ * Map node names to enabled breakers with that node name,
+ * and map output objects to enabled connections from that object.
+ * The index is created once per call to getConnectionInfo().
+ */
+struct GraphTraversalIndex
+{
+    GraphTraversalIndex(const GraphObjectList &graphObjects)
+    {
+        for (auto graphObject : graphObjects)
+        {
+            auto breaker = qobject_cast<GraphBreaker *>(graphObject);
+            if (breaker != nullptr and breaker->isEnabled())
+            {
+                nodeNameToBreakers[breaker->getNodeName()].push_back(breaker);
+            }
+
+            auto connection = qobject_cast<GraphConnection *>(graphObject);
+            if (connection != nullptr and connection->isEnabled())
+            {
+                outputObjToConnections[connection->getOutputEndpoint().getObj().data()].push_back(connection);
+            }
+        }
+    }
+
+    std::map<QString, std::vector<GraphBreaker *>> nodeNameToBreakers;
+    std::unordered_map<GraphObject *, std::vector<GraphConnection *>> outputObjToConnections;
+};
 
 /*!
  * Given an input endpoint, discover all of the "resolved" input endpoints by traversing breakers of the same node name.
+ * The traversed set is shared by the entire traversal so that each endpoint is visited once.
  */
-static std::vector<GraphConnectionEndpoint> traverseInputEps(
+static void traverseInputEps(
     const GraphConnectionEndpoint &inputEp,
-    const GraphObjectList &graphObjects,
-    std::vector<GraphConnectionEndpoint> traversed = std::vector<GraphConnectionEndpoint>()
-)
+    const GraphTraversalIndex &index,
+    std::unordered_set<GraphConnectionEndpoint> &traversed,
+    std::vector<GraphConnectionEndpoint> &inputEndpoints)
 {
-    std::vector<GraphConnectionEndpoint> inputEndpoints;
-    if (not inputEp.getObj()->isEnabled()) return inputEndpoints;
+    if (not inputEp.getObj()->isEnabled()) return;
 
     //avoid recursive loops by keeping track of traversed endpoints
-    auto it = std::find(traversed.begin(), traversed.end(), inputEp);
-    if (it != traversed.end()) return inputEndpoints;
-    traversed.push_back(inputEp);
+    if (not traversed.insert(inputEp).second) return;
 
     auto inputBlock = qobject_cast<GraphBlock *>(inputEp.getObj().data());
     auto inputBreaker = qobject_cast<GraphBreaker *>(inputEp.getObj().data());
@@ -33,39 +65,29 @@ static std::vector<GraphConnectionEndpoint> traverseInputEps(
 
     if (inputBreaker != nullptr)
     {
-        auto nodeName = inputBreaker->getNodeName();
-        for (auto graphObject : graphObjects)
+        auto breakersIt = index.nodeNameToBreakers.find(inputBreaker->getNodeName());
+        if (breakersIt == index.nodeNameToBreakers.end()) return;
+        for (auto breaker : breakersIt->second)
         {
-            auto breaker = qobject_cast<GraphBreaker *>(graphObject);
-            if (breaker == nullptr) continue;
-            if (not breaker->isEnabled()) continue;
-            if (breaker->getNodeName() != nodeName) continue;
             if (breaker == inputBreaker) continue;
             //follow all connections from this breaker to an input
             //this is the recursive part
-            for (auto graphSubObject : graphObjects)
+            auto connsIt = index.outputObjToConnections.find(breaker);
+            if (connsIt == index.outputObjToConnections.end()) continue;
+            for (auto connection : connsIt->second)
             {
-                auto connection = qobject_cast<GraphConnection *>(graphSubObject);
-                if (connection == nullptr) continue;
-                if (not connection->isEnabled()) continue;
-                if (connection->getOutputEndpoint().getObj() != breaker) continue;
                 for (const auto &epPair : connection->getEndpointPairs())
                 {
-                    const auto &inputEp = epPair.second;
-                    for (const auto &subEp : traverseInputEps(inputEp, graphObjects, traversed))
-                    {
-                        inputEndpoints.push_back(subEp);
-                    }
+                    traverseInputEps(epPair.second, index, traversed, inputEndpoints);
                 }
             }
         }
     }
-
-    return inputEndpoints;
 }
 
 ConnectionInfos TopologyEval::getConnectionInfo(const GraphObjectList &graphObjects)
 {
+    const GraphTraversalIndex index(graphObjects);
     ConnectionInfos connections;
     for (auto graphObject : graphObjects)
     {
@@ -84,14 +106,17 @@ ConnectionInfos TopologyEval::getConnectionInfo(const GraphObjectList &graphObje
             auto outputBreaker = qobject_cast<GraphBreaker *>(outputEp.getObj().data());
             if (outputBreaker != nullptr) continue;
 
-            for (const auto &subEp : traverseInputEps(inputEp, graphObjects))
+            std::unordered_set<GraphConnectionEndpoint> traversed;
+            std::vector<GraphConnectionEndpoint> inputEndpoints;
+            traverseInputEps(inputEp, index, traversed, inputEndpoints);
+            for (const auto &subEp : inputEndpoints)
             {
                 ConnectionInfo info;
                 info.srcBlockUID = outputEp.getObj()->uid();
                 info.srcPort = outputEp.getKey().id;
                 info.dstBlockUID = subEp.getObj()->uid();
                 info.dstPort = subEp.getKey().id;
-                connections.push_back(info);
+                connections.insert(info);
             }
         }
     }
@@ -0,0 +1,104 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "GraphEditor/EvalMetricsDock.hpp"
+#include "EvalEngine/EvalMetrics.hpp"
+#include "MainWindow/IconUtils.hpp"
+#include <QTreeWidget>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFileDialog>
+#include <QJsonDocument>
+#include <QTimer>
+#include <QFile>
+#include <QDir>
+
+static const int REFRESH_INTERVAL_MS = 1000;
+
+EvalMetricsDock::EvalMetricsDock(QWidget *parent):
+    QDockWidget(parent),
+    _logger(Poco::Logger::get("PothosFlow.EvalMetricsDock")),
+    _metricsTree(new QTreeWidget(this)),
+    _timer(new QTimer(this))
+{
+    this->setObjectName("EvalMetricsDock");
+    this->setWindowTitle(tr("Evaluation Latency"));
+
+    auto mainWidget = new QWidget(this);
+    auto topLayout = new QVBoxLayout(mainWidget);
+    auto buttonLayout = new QHBoxLayout();
+    topLayout->addLayout(buttonLayout);
+    topLayout->addWidget(_metricsTree);
+    this->setWidget(mainWidget);
+
+    //setup the buttons
+    auto resetButton = new QPushButton(makeIconFromTheme("edit-clear"), tr("Reset"), mainWidget);
+    auto exportButton = new QPushButton(makeIconFromTheme("document-save-as"), tr("Export JSON"), mainWidget);
+    buttonLayout->addWidget(resetButton);
+    buttonLayout->addWidget(exportButton);
+    buttonLayout->addStretch();
+
+    //setup the metrics tree
+    _metricsTree->setColumnCount(5);
+    _metricsTree->setHeaderLabels({tr("Phase"), tr("Count"), tr("p50 (ms)"), tr("p99 (ms)"), tr("max (ms)")});
+    _metricsTree->setRootIsDecorated(false);
+    _metricsTree->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+    //connect the signals
+    connect(resetButton, &QPushButton::clicked, this, &EvalMetricsDock::handleReset);
+    connect(exportButton, &QPushButton::clicked, this, &EvalMetricsDock::handleExport);
+    connect(_timer, &QTimer::timeout, this, &EvalMetricsDock::handleRefresh);
+    connect(this, &QDockWidget::visibilityChanged, this, &EvalMetricsDock::handleVisibilityChanged);
+}
+
+void EvalMetricsDock::handleRefresh(void)
+{
+    const auto metrics = EvalMetrics::global().toJSON();
+    _metricsTree->clear();
+    for (const auto &phase : metrics.keys())
+    {
+        const auto phaseObj = metrics[phase].toObject();
+        auto item = new QTreeWidgetItem(_metricsTree);
+        item->setText(0, phase);
+        item->setText(1, QString::number(qint64(phaseObj["count"].toDouble())));
+        item->setText(2, QString::number(phaseObj["p50Ms"].toDouble(), 'f', 3));
+        item->setText(3, QString::number(phaseObj["p99Ms"].toDouble(), 'f', 3));
+        item->setText(4, QString::number(phaseObj["maxMs"].toDouble(), 'f', 3));
+        for (int i = 1; i < 5; i++) item->setTextAlignment(i, Qt::AlignRight);
+    }
+}
+
+void EvalMetricsDock::handleReset(void)
+{
+    EvalMetrics::global().reset();
+    this->handleRefresh();
+}
+
+void EvalMetricsDock::handleExport(void)
+{
+    const auto fileName = QFileDialog::getSaveFileName(this,
+                        tr("Export evaluation latency"),
+                        QDir::home().filePath("eval_latency.json"),
+                        tr("JSON (*.json)"));
+    if (fileName.isEmpty()) return;
+
+    QFile jsonFile(fileName);
+    const auto data = QJsonDocument(EvalMetrics::global().toJSON()).toJson();
+    if (not jsonFile.open(QFile::WriteOnly) or jsonFile.write(data) == -1)
+    {
+        _logger.error("Error exporting %s: %s", fileName.toStdString(), jsonFile.errorString().toStdString());
+    }
+}
+
+void EvalMetricsDock::handleVisibilityChanged(const bool visible)
+{
+    //only poll the metrics while the panel is shown
+    if (visible)
+    {
+        this->handleRefresh();
+        _timer->start(REFRESH_INTERVAL_MS);
+    }
+    else _timer->stop();
+}
@@ -0,0 +1,29 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Config.hpp>
+#include <QDockWidget>
+#include <Poco/Logger.h>
+
+class QTreeWidget;
+class QTimer;
+
+//! A top level dock widget for showing evaluation latency metrics
+class EvalMetricsDock : public QDockWidget
+{
+    Q_OBJECT
+public:
+    EvalMetricsDock(QWidget *parent);
+
+private slots:
+    void handleRefresh(void);
+    void handleReset(void);
+    void handleExport(void);
+    void handleVisibilityChanged(const bool visible);
+
+private:
+    Poco::Logger &_logger;
+    QTreeWidget *_metricsTree;
+    QTimer *_timer;
+};
@@ -11,6 +11,7 @@
 #include "GraphObjects/GraphConnection.hpp"
 #include "GraphObjects/GraphWidget.hpp"
 #include "BlockTree/BlockTreeDock.hpp"
+#include "BlockTree/BlockCache.hpp"
 #include "AffinitySupport/AffinityZonesDock.hpp"
 #include "AffinitySupport/AffinityZonesMenu.hpp"
 #include "MainWindow/MainActions.hpp"
@@ -33,6 +34,8 @@
 #include <QTimer>
 #include <QUuid>
 #include <QFileInfo>
+#include <QFileDialog>
+#include <QDir>
 #include <iostream>
 #include <cassert>
 #include <set>
@@ -78,6 +81,7 @@ GraphEditor::GraphEditor(QWidget *parent):
     connect(actions->copyAction, &QAction::triggered, this, &GraphEditor::handleCopy);
     connect(actions->pasteAction, &QAction::triggered, this, &GraphEditor::handlePaste);
     connect(blockTreeDock, &BlockTreeDock::addBlockEvent, this, &GraphEditor::handleAddBlockSlot);
+    connect(BlockCache::global(), &BlockCache::blockDescChanges, this, &GraphEditor::handleBlockDescChanges);
     connect(actions->selectAllAction, &QAction::triggered, this, &GraphEditor::handleSelectAll);
     connect(actions->deleteAction, &QAction::triggered, this, &GraphEditor::handleDelete);
     connect(actions->rotateLeftAction, &QAction::triggered, this, &GraphEditor::handleRotateLeft);
@@ -96,6 +100,8 @@ GraphEditor::GraphEditor(QWidget *parent):
     connect(affinityZonesDock, &AffinityZonesDock::zoneChanged, this, &GraphEditor::handleAffinityZoneChanged);
     connect(actions->showRenderedGraphAction, &QAction::triggered, this, &GraphEditor::handleShowRenderedGraphDialog);
     connect(actions->showTopologyStatsAction, &QAction::triggered, this, &GraphEditor::handleShowTopologyStatsDialog);
+    connect(actions->recordEvalTraceAction, &QAction::toggled, this, &GraphEditor::handleToggleRecordEvalTrace);
+    connect(actions->exportEvalTraceAction, &QAction::triggered, this, &GraphEditor::handleExportEvalTrace);
     connect(actions->activateTopologyAction, &QAction::toggled, this, &GraphEditor::handleToggleActivateTopology);
     connect(actions->showPortNamesAction, &QAction::changed, this, &GraphEditor::handleBlockDisplayModeChange);
     connect(actions->eventPortsInlineAction, &QAction::changed, this, &GraphEditor::handleBlockDisplayModeChange);
@@ -105,6 +111,7 @@ GraphEditor::GraphEditor(QWidget *parent):
     connect(mainMenu->editMenu, &QMenu::aboutToShow, this, &GraphEditor::updateGraphEditorMenus);
     connect(this, &DockingTabWidget::activeChanged, this, &GraphEditor::updateEnabledActions);
     _pollWidgetTimer->start(POLL_WIDGET_CHANGES_MS);
+    _evalEngine->setTraceRecording(actions->recordEvalTraceAction->isChecked());
 }
 
 GraphEditor::~GraphEditor(void)
@@ -138,6 +145,7 @@ void GraphEditor::restartEvaluation(void)
     }
 
     _evalEngine = new EvalEngine(this);
+    _evalEngine->setTraceRecording(MainActions::global()->recordEvalTraceAction->isChecked());
     connect(_evalEngine, &EvalEngine::deactivateDesign, this, &GraphEditor::handleEvalEngineDeactivate);
     _evalEngine->submitTopology(this->getGraphObjects());
     _evalEngine->submitActivateTopology(_isTopologyActive);
@@ -923,12 +931,48 @@ void GraphEditor::handleStateChange(const GraphState &state)
 void GraphEditor::handleToggleActivateTopology(const bool enable)
 {
     if (not this->isActive()) return;
+    this->setTopologyActive(enable);
+}
+
+void GraphEditor::setTopologyActive(const bool enable)
+{
     if (_evalEngine == nullptr) return;
     _evalEngine->submitActivateTopology(enable);
     _isTopologyActive = enable;
     this->updateEnabledActions();
 }
 
+QByteArray GraphEditor::getTopologyJSONStats(void)
+{
+    if (_evalEngine == nullptr) return QByteArray();
+    return _evalEngine->getTopologyJSONStats();
+}
+
+void GraphEditor::handleToggleRecordEvalTrace(const bool enable)
+{
+    //recording applies to all editors, not just the active one
+    if (_evalEngine == nullptr) return;
+    _evalEngine->setTraceRecording(enable);
+}
+
+void GraphEditor::handleExportEvalTrace(void)
+{
+    if (not this->isActive()) return;
+    if (_evalEngine == nullptr) return;
+
+    auto fileName = QFileDialog::getSaveFileName(this,
+                        tr("Export evaluation trace"),
+                        QDir::home().filePath("eval_trace.json"),
+                        tr("Chrome trace JSON (*.json)"));
+    if (fileName.isEmpty()) return;
+
+    QFile jsonFile(fileName);
+    if (not jsonFile.open(QFile::WriteOnly) or jsonFile.write(_evalEngine->getEvalChromeTrace()) == -1)
+    {
+        _logger.error("Error exporting %s: %s", fileName.toStdString(), jsonFile.errorString().toStdString());
+    }
+}
+
 void GraphEditor::handleBlockDisplayModeChange(void)
 {
     for (auto obj : this->getGraphObjects(GRAPH_BLOCK))
@@ -978,6 +1022,28 @@ void GraphEditor::handleBlockXcrement(const int adj)
     if (adj < 0) handleStateChange(GraphState("list-remove", tr("Decrement %1").arg(desc)));
 }
 
+void GraphEditor::handleBlockDescChanges(const QJsonArray &added, const QJsonArray &changed, const QStringList &)
+{
+    //reload the blocks of this editor that use a new or changed path,
+    //blocks of removed paths keep their last description
+    std::map<QString, QJsonObject> pathToBlockDesc;
+    for (const auto &blockDescs : {added, changed})
+    {
+        for (const auto &blockDescVal : blockDescs)
+        {
+            const auto blockDesc = blockDescVal.toObject();
+            pathToBlockDesc[blockDesc["path"].toString()] = blockDesc;
+        }
+    }
+
+    for (auto obj : this->getGraphObjects(GRAPH_BLOCK))
+    {
+        auto block = qobject_cast<GraphBlock *>(obj);
+        auto it = pathToBlockDesc.find(block->getBlockDescPath());
+        if (it != pathToBlockDesc.end()) block->reloadBlockDesc(it->second);
+    }
+}
+
 void GraphEditor::updateExecutionEngine(void)
 {
     this->deleteFlagged(); //scan+remove deleted before submit
@@ -1037,12 +1103,7 @@ void GraphEditor::load(void)
     _stateManager->saveCurrent();
     this->render();
 
-    if (_autoActivate)
-    {
-        _evalEngine->submitActivateTopology(true);
-        _isTopologyActive = true;
-        this->updateEnabledActions();
-    }
+    if (_autoActivate) this->setTopologyActive(true);
 }
 
 void GraphEditor::render(void)
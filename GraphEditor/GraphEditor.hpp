@@ -8,6 +8,8 @@
 #include "GraphEditor/DockingTabWidget.hpp"
 #include <Poco/Logger.h>
 #include <QJsonObject>
+#include <QJsonArray>
+#include <QStringList>
 #include <QPointer>
 
 class GraphConnection;
@@ -115,6 +117,18 @@ public:
         _autoActivate = enb;
     }
 
+    //! Activate or deactivate the topology, even when this editor is not focused
+    void setTopologyActive(const bool enable);
+
+    //! Is the topology activated?
+    bool isTopologyActive(void) const
+    {
+        return _isTopologyActive;
+    }
+
+    //! Query the stats of the running topology (blocks until the eval thread replies)
+    QByteArray getTopologyJSONStats(void);
+
     //! Is lock topology enabled?
     bool isTopologyLocked(void) const
     {
@@ -150,6 +164,7 @@ private slots:
     void handleDeleteGraphPage(void);
     void handleMoveGraphObjects(const int index);
     void handleAddBlockSlot(const QJsonObject &);
+    void handleBlockDescChanges(const QJsonArray &added, const QJsonArray &changed, const QStringList &removed);
     void handleCreateBreaker(const bool isInput);
     void handleCreateInputBreaker(void);
     void handleCreateOutputBreaker(void);
@@ -178,6 +193,8 @@ private slots:
     void handleAffinityZoneChanged(const QString &zone);
     void handleShowRenderedGraphDialog(void);
     void handleShowTopologyStatsDialog(void);
+    void handleToggleRecordEvalTrace(bool);
+    void handleExportEvalTrace(void);
     void handleToggleActivateTopology(bool);
     void handleBlockDisplayModeChange(void);
     void handleBlockIncrement(void);
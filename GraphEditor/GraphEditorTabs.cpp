@@ -1,4 +1,4 @@
-// Copyright (c) 2014-2021 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #include "MainWindow/IconUtils.hpp"
@@ -112,13 +112,18 @@ void GraphEditorTabs::handleOpen(const QString &filePath)
     }
 
     //open a new editor with the specified file
+    this->openFile(filePath);
+    this->saveState();
+}
+
+GraphEditor *GraphEditorTabs::openFile(const QString &filePath)
+{
     auto editor = new GraphEditor(this);
     editor->setCurrentFilePath(filePath);
     this->addTab(editor, "");
     editor->load();
     this->setCurrentWidget(editor);
-
-    this->saveState();
+    return editor;
 }
 
 void GraphEditorTabs::handleSave(void)
@@ -1,4 +1,4 @@
-// Copyright (c) 2014-2021 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #pragma once
@@ -16,6 +16,9 @@ public:
     GraphEditor *getGraphEditor(const int index) const;
     GraphEditor *getCurrentGraphEditor(void) const;
 
+    //! Open the file in a new editor without saving the tab state
+    GraphEditor *openFile(const QString &filePath);
+
 public slots:
 
     void loadState(void);
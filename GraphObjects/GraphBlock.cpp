@@ -1,4 +1,4 @@
-// Copyright (c) 2013-2018 Josh Blum
+// Copyright (c) 2013-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #include "GraphObjects/GraphBlockImpl.hpp"
@@ -35,15 +35,27 @@ GraphBlock::~GraphBlock(void)
 
 QString GraphBlock::getBlockDescPath(void) const
 {
-    return _impl->blockDesc["path"].toString();
+    return _impl->blockDesc->getPath();
 }
 
 const QJsonObject &GraphBlock::getBlockDesc(void) const
+{
+    assert(_impl);
+    return _impl->blockDesc->getJSON();
+}
+
+const std::shared_ptr<const BlockDesc> &GraphBlock::getSharedBlockDesc(void) const
 {
     assert(_impl);
     return _impl->blockDesc;
 }
 
+bool GraphBlock::isBlockDescPending(void) const
+{
+    assert(_impl);
+    return _impl->blockDescPending;
+}
+
 static void paramKeysFromJSON(QSet<QString> &keys, const QJsonObject &desc)
 {
     for (const auto &paramValue : desc["params"].toArray())
@@ -956,6 +968,8 @@ void GraphBlock::deserialize(const QJsonObject &obj)
     //Can't find the block description?
     //Generate a pseudo description so that the block will appear
     //in the editor with the same properties and connections.
+    //The block cache looks up the path in the background,
+    //and the pseudo description is replaced when it is found.
     if (blockDesc.isEmpty())
     {
         QJsonObject blockDescFallback;
@@ -970,8 +984,10 @@ void GraphBlock::deserialize(const QJsonObject &obj)
             blockParams.push_back(paramObj);
         }
         blockDescFallback["params"] = blockParams;
-        _impl->logger.error("Cant find block factory with path: '%s'", path.toStdString());
         this->setBlockDesc(blockDescFallback);
+        _impl->blockDescPending = true;
+        connect(BlockCache::global(), &BlockCache::blockDescResolved,
+            this, &GraphBlock::handleBlockDescResolved, Qt::UniqueConnection);
     }
 
     else this->setBlockDesc(blockDesc);
@@ -993,3 +1009,35 @@ void GraphBlock::deserialize(const QJsonObject &obj)
 
     GraphObject::deserialize(obj);
 }
+
+void GraphBlock::handleBlockDescResolved(const QString &path, const QJsonObject &blockDesc)
+{
+    if (path != this->getBlockDescPath()) return;
+    disconnect(BlockCache::global(), &BlockCache::blockDescResolved,
+        this, &GraphBlock::handleBlockDescResolved);
+    this->reloadBlockDesc(blockDesc);
+}
+
+void GraphBlock::reloadBlockDesc(const QJsonObject &blockDesc)
+{
+    _impl->blockDescPending = false;
+    if (blockDesc == this->getBlockDesc()) return;
+
+    //keep the loaded property values over the defaults from the description
+    std::map<QString, QString> values, editModes;
+    for (const auto &propKey : this->getProperties())
+    {
+        values[propKey] = this->getPropertyValue(propKey);
+        editModes[propKey] = this->getPropertyEditMode(propKey);
+    }
+    this->setBlockDesc(blockDesc);
+    for (const auto &propKey : this->getProperties())
+    {
+        if (values.count(propKey) == 0) continue;
+        this->setPropertyValue(propKey, values.at(propKey));
+        this->setPropertyEditMode(propKey, editModes.at(propKey));
+    }
+
+    //evaluate again with the real description
+    emit this->triggerEvalEvent();
+}
@@ -1,4 +1,4 @@
-// Copyright (c) 2013-2018 Josh Blum
+// Copyright (c) 2013-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #pragma once
@@ -14,6 +14,7 @@
 #include <vector>
 
 class QWidget;
+class BlockDesc;
 
 class GraphBlock : public GraphObject
 {
@@ -24,9 +25,25 @@ public:
 
     //! set the block description from JSON object
     void setBlockDesc(const QJsonObject &);
+
+    /*!
+     * Replace the description of a loaded block.
+     * The property values are kept and the block is evaluated again.
+     */
+    void reloadBlockDesc(const QJsonObject &);
     const QJsonObject &getBlockDesc(void) const;
     QString getBlockDescPath(void) const;
 
+    //! The interned block description, shared with the evaluation
+    const std::shared_ptr<const BlockDesc> &getSharedBlockDesc(void) const;
+
+    /*!
+     * Is the block using a placeholder description?
+     * The placeholder lacks the mode, arguments, and calls,
+     * so the block is not evaluated until the real description loads.
+     */
+    bool isBlockDescPending(void) const;
+
     //! set the input ports description from JSON array
     void setInputPortDesc(const QJsonArray &);
 
@@ -145,6 +162,11 @@ signals:
     //! Called when the overlay changes the param description
     void paramDescChanged(const QString &key, const QJsonObject &desc);
 
+private slots:
+
+    //! Replace the pseudo description when the block cache finds the path
+    void handleBlockDescResolved(const QString &path, const QJsonObject &desc);
+
 protected:
 
     //! Block uses this to respond to selection changes
@@ -1,9 +1,10 @@
-// Copyright (c) 2013-2017 Josh Blum
+// Copyright (c) 2013-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #pragma once
 #include <Pothos/Config.hpp>
 #include "GraphObjects/GraphBlock.hpp"
+#include "BlockTree/BlockDesc.hpp"
 #include <QColor>
 #include <QPen>
 #include <QRectF>
@@ -18,6 +19,8 @@ struct GraphBlock::Impl
     Impl(void):
         logger(Poco::Logger::get("PothosFlow.GraphBlock")),
         isGraphWidget(false),
+        blockDescPending(false),
+        blockDesc(BlockDesc::intern(QJsonObject())),
         signalPortUseCount(0),
         slotPortUseCount(0),
         showPortNames(false),
@@ -28,7 +31,8 @@ struct GraphBlock::Impl
 
     Poco::Logger &logger;
     bool isGraphWidget;
-    QJsonObject blockDesc;
+    bool blockDescPending;
+    BlockDesc::Sptr blockDesc;
     QJsonObject overlayDesc;
     QJsonArray inputDesc;
     QJsonArray outputDesc;
@@ -1,4 +1,4 @@
-// Copyright (c) 2014-2017 Josh Blum
+// Copyright (c) 2014-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #include "GraphObjects/GraphBlockImpl.hpp"
@@ -10,8 +10,8 @@
  **********************************************************************/
 void GraphBlock::setBlockDesc(const QJsonObject &blockDesc)
 {
-    if (_impl->blockDesc == blockDesc) return;
-    _impl->blockDesc = blockDesc;
+    if (_impl->blockDesc->getJSON() == blockDesc) return;
+    _impl->blockDesc = BlockDesc::intern(blockDesc);
 
     //extract the name or title from the description
     if (not blockDesc.contains("name"))
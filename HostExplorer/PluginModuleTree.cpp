@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: BSL-1.0
 
 #include "HostExplorer/PluginModuleTree.hpp"
+#include "HostExplorer/PluginModuleUtils.hpp"
 #include <Pothos/System/Version.hpp> //POTHOS_API_VERSION
 #include <Pothos/Remote.hpp>
 #include <Pothos/Proxy.hpp>
@@ -25,9 +26,6 @@ static void loadModuleMap(PluginModuleTree::ModInfoType &info, const Pothos::Plu
     if (not dump.objectType.empty())
     {
         info.modMap[dump.modulePath].push_back(dump.pluginPath);
-        #ifdef HAS_MODULE_VERSION
-        info.modVers[dump.modulePath] = dump.moduleVersion;
-        #endif
     }
 
     for (const auto &subInfo : dump.subInfo)
@@ -47,6 +45,7 @@ static PluginModuleTree::ModInfoType getRegistryDump(const std::string &uriStr)
         auto env = Pothos::RemoteClient(uriStr).makeEnvironment("managed");
         const Pothos::PluginRegistryInfoDump dump = env->findProxy("Pothos/PluginRegistry").call("dump");
         loadModuleMap(info, dump);
+        loadModuleVersions(info.modVers, dump);
     }
     catch (const Pothos::Exception &ex)
     {
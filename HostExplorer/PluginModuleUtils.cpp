@@ -0,0 +1,26 @@
+// Copyright (c) 2013-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "HostExplorer/PluginModuleUtils.hpp"
+#include <Pothos/System/Version.hpp> //POTHOS_API_VERSION
+
+#if POTHOS_API_VERSION >= 0x00070000
+#define HAS_MODULE_VERSION
+#endif
+
+void loadModuleVersions(std::map<std::string, std::string> &modVers, const Pothos::PluginRegistryInfoDump &dump)
+{
+    if (not dump.objectType.empty())
+    {
+        #ifdef HAS_MODULE_VERSION
+        modVers[dump.modulePath] = dump.moduleVersion;
+        #else
+        modVers[dump.modulePath];
+        #endif
+    }
+
+    for (const auto &subInfo : dump.subInfo)
+    {
+        loadModuleVersions(modVers, subInfo);
+    }
+}
@@ -0,0 +1,14 @@
+// Copyright (c) 2013-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Config.hpp>
+#include <Pothos/Plugin.hpp>
+#include <string>
+#include <map>
+
+/*!
+ * Load the module path and module version of each plugin in a registry dump.
+ * The version is left empty when the framework does not report versions.
+ */
+void loadModuleVersions(std::map<std::string, std::string> &modVers, const Pothos::PluginRegistryInfoDump &dump);
@@ -0,0 +1,17 @@
+// Copyright (c) 2013-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Config.hpp>
+#include <QString>
+#include <QtGlobal>
+
+//! Forward Qt log messages into the Poco logger of the message category
+void myQLogHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg);
+
+//! Run the syslog listener for the lifetime of the application
+struct MyScopedSyslogListener
+{
+    MyScopedSyslogListener(void);
+    ~MyScopedSyslogListener(void);
+};
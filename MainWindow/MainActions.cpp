@@ -128,6 +128,13 @@ MainActions::MainActions(QObject *parent):
 
     showTopologyStatsAction = new QAction(tr("Show topology stats dump"), this);
 
+    recordEvalTraceAction = new QAction(tr("Record evaluation trace"), this);
+    recordEvalTraceAction->setCheckable(true);
+    recordEvalTraceAction->setStatusTip(tr("Record timed spans of the evaluator for export"));
+
+    exportEvalTraceAction = new QAction(tr("Export evaluation trace..."), this);
+    exportEvalTraceAction->setStatusTip(tr("Save the recorded evaluation trace as Chrome trace JSON"));
+
     activateTopologyAction = new QAction(makeIconFromTheme("run-build"), tr("&Activate topology"), this);
     activateTopologyAction->setCheckable(true);
     activateTopologyAction->setShortcut(QKeySequence("F6"));
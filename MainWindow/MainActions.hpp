@@ -58,6 +58,8 @@ public:
     QAction *showGraphBoundingBoxesAction;
     QAction *showRenderedGraphAction;
     QAction *showTopologyStatsAction;
+    QAction *recordEvalTraceAction;
+    QAction *exportEvalTraceAction;
     QAction *activateTopologyAction;
     QAction *showPortNamesAction;
     QAction *eventPortsInlineAction;
@@ -74,6 +74,8 @@ MainMenu::MainMenu(QMainWindow *parent, MainActions *actions):
     executeMenu->addAction(actions->activateTopologyAction);
     executeMenu->addAction(actions->showRenderedGraphAction);
     executeMenu->addAction(actions->showTopologyStatsAction);
+    executeMenu->addAction(actions->recordEvalTraceAction);
+    executeMenu->addAction(actions->exportEvalTraceAction);
     executeMenu->addAction(actions->reloadPluginsAction);
 
     viewMenu = parent->menuBar()->addMenu(tr("&View"));
@@ -1,4 +1,4 @@
-// Copyright (c) 2013-2021 Josh Blum
+// Copyright (c) 2013-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #include "MainWindow/MainWindow.hpp"
@@ -11,6 +11,7 @@
 #include "GraphEditor/GraphEditor.hpp"
 #include "GraphEditor/GraphEditorTabs.hpp"
 #include "GraphEditor/GraphActionsDock.hpp"
+#include "GraphEditor/EvalMetricsDock.hpp"
 #include "HostExplorer/HostExplorerDock.hpp"
 #include "AffinitySupport/AffinityZonesDock.hpp"
 #include "MessageWindow/MessageWindowDock.hpp"
@@ -31,9 +32,10 @@ MainWindow *MainWindow::global(void)
     return globalMainWindow;
 }
 
-MainWindow::MainWindow(QWidget *parent):
+MainWindow::MainWindow(QWidget *parent, const bool headless):
     QMainWindow(parent),
     _logger(Poco::Logger::get("PothosFlow.MainWindow")),
+    _headless(headless),
     _splash(new MainSplash(this)),
     _settings(new MainSettings(this)),
     _actions(nullptr),
@@ -43,7 +45,7 @@ MainWindow::MainWindow(QWidget *parent):
 {
     globalMainWindow = this;
 
-    _splash->show();
+    if (not _headless) _splash->show();
     _splash->postMessage(tr("Creating main window..."));
 
     _splash->postMessage(tr("Launching scratch process..."));
@@ -83,6 +85,12 @@ MainWindow::MainWindow(QWidget *parent):
     auto graphActionsDock = new GraphActionsDock(this);
     this->addDockWidget(Qt::BottomDockWidgetArea, graphActionsDock);
 
+    //create evaluation latency dock
+    _splash->postMessage(tr("Creating latency panel..."));
+    auto evalMetricsDock = new EvalMetricsDock(this);
+    this->tabifyDockWidget(graphActionsDock, evalMetricsDock);
+    evalMetricsDock->hide(); //hidden unless restored below
+
     //create host explorer dock
     _splash->postMessage(tr("Creating host explorer..."));
     auto hostExplorerDock = new HostExplorerDock(this);
@@ -105,7 +113,7 @@ MainWindow::MainWindow(QWidget *parent):
     _splash->postMessage(tr("Creating graph editor..."));
     _editorTabs = new GraphEditorTabs(this);
     this->setCentralWidget(_editorTabs);
-    connect(this, &MainWindow::initDone, _editorTabs, &GraphEditorTabs::loadState);
+    if (not _headless) connect(this, &MainWindow::initDone, _editorTabs, &GraphEditorTabs::loadState);
     connect(this, &MainWindow::exitBegin, _editorTabs, &GraphEditorTabs::handleExit);
 
     //create block tree (after the block cache)
@@ -120,9 +128,10 @@ MainWindow::MainWindow(QWidget *parent):
     this->tabifyDockWidget(blockTreeDock, _propertiesPanel);
 
     //restore main window settings from file
+    //headless mode leaves the window state of the GUI alone
     _splash->postMessage(tr("Restoring configuration..."));
-    this->restoreGeometry(_settings->value("MainWindow/geometry").toByteArray());
-    this->restoreState(_settings->value("MainWindow/state").toByteArray());
+    if (not _headless) this->restoreGeometry(_settings->value("MainWindow/geometry").toByteArray());
+    if (not _headless) this->restoreState(_settings->value("MainWindow/state").toByteArray());
     _propertiesPanel->hide(); //hidden until used
     _actions->showPortNamesAction->setChecked(_settings->value("MainWindow/showPortNames", true).toBool());
     _actions->eventPortsInlineAction->setChecked(_settings->value("MainWindow/eventPortsInline", true).toBool());
@@ -135,27 +144,21 @@ MainWindow::MainWindow(QWidget *parent):
     viewMenu->addAction(hostExplorerDock->toggleViewAction());
     viewMenu->addAction(messageWindowDock->toggleViewAction());
     viewMenu->addAction(graphActionsDock->toggleViewAction());
+    viewMenu->addAction(evalMetricsDock->toggleViewAction());
     viewMenu->addAction(blockTreeDock->toggleViewAction());
     viewMenu->addAction(affinityZonesDock->toggleViewAction());
     viewMenu->addAction(mainToolBar->toggleViewAction());
+    mainMenu->executeMenu->addAction(evalMetricsDock->toggleViewAction());
 
     //setup is complete, show the window and signal done
-    this->show();
+    if (not _headless) this->show();
     connect(this, &MainWindow::initDone, this, &MainWindow::handleInitDone);
     emit this->initDone();
 }
 
 MainWindow::~MainWindow(void)
 {
-    _logger.information("Save application state");
-    this->handleFullScreenViewAction(false); //undo if set -- so we dont save full mode below
-    _settings->setValue("MainWindow/geometry", this->saveGeometry());
-    _settings->setValue("MainWindow/state", this->saveState());
-    _settings->setValue("MainWindow/showPortNames", _actions->showPortNamesAction->isChecked());
-    _settings->setValue("MainWindow/eventPortsInline", _actions->eventPortsInlineAction->isChecked());
-    _settings->setValue("MainWindow/clickConnectMode", _actions->clickConnectModeAction->isChecked());
-    _settings->setValue("MainWindow/showGraphConnectionPoints", _actions->showGraphConnectionPointsAction->isChecked());
-    _settings->setValue("MainWindow/showGraphBoundingBoxes", _actions->showGraphBoundingBoxesAction->isChecked());
+    if (not _headless) this->saveSettings();
 
     //close any open properties panel editor window
     _propertiesPanel->launchEditor(nullptr);
@@ -175,10 +178,24 @@ MainWindow::~MainWindow(void)
     _server = Pothos::RemoteServer();
 }
 
+void MainWindow::saveSettings(void)
+{
+    _logger.information("Save application state");
+    this->handleFullScreenViewAction(false); //undo if set -- so we dont save full mode below
+    _settings->setValue("MainWindow/geometry", this->saveGeometry());
+    _settings->setValue("MainWindow/state", this->saveState());
+    _settings->setValue("MainWindow/showPortNames", _actions->showPortNamesAction->isChecked());
+    _settings->setValue("MainWindow/eventPortsInline", _actions->eventPortsInlineAction->isChecked());
+    _settings->setValue("MainWindow/clickConnectMode", _actions->clickConnectModeAction->isChecked());
+    _settings->setValue("MainWindow/showGraphConnectionPoints", _actions->showGraphConnectionPointsAction->isChecked());
+    _settings->setValue("MainWindow/showGraphBoundingBoxes", _actions->showGraphBoundingBoxesAction->isChecked());
+}
+
 void MainWindow::handleInitDone(void)
 {
     _splash->postMessage(tr("Completing initialization..."));
-    _splash->finish(this);
+    if (_headless) _splash->close();
+    else _splash->finish(this);
     _logger.information("Initialization complete");
 }
 
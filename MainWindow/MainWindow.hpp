@@ -1,4 +1,4 @@
-// Copyright (c) 2013-2018 Josh Blum
+// Copyright (c) 2013-2026 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
 #pragma once
@@ -31,12 +31,24 @@ public:
     //! Global access to main window
     static MainWindow *global(void);
 
-    MainWindow(QWidget *parent);
+    /*!
+     * Create the main window.
+     * In headless mode the window is never shown,
+     * the last opened files are not restored,
+     * and the window settings are left untouched.
+     */
+    MainWindow(QWidget *parent, const bool headless = false);
 
     ~MainWindow(void);
 
     void setWindowTitle(const QString &s);
 
+    //! Get access to the graph editor tabs
+    GraphEditorTabs *getEditorTabs(void) const
+    {
+        return _editorTabs;
+    }
+
 signals:
     void initDone(void);
     void exitBegin(QCloseEvent *);
@@ -56,6 +68,7 @@ protected:
 
 private:
     Poco::Logger &_logger;
+    const bool _headless;
     MainSplash *_splash;
     MainSettings *_settings;
     MainActions *_actions;
@@ -69,4 +82,7 @@ private:
 
     //! Setup server for scratch process
     void setupServer(void);
+
+    //! Save the window state and view options
+    void saveSettings(void);
 };
@@ -2,47 +2,16 @@
 // SPDX-License-Identifier: BSL-1.0
 
 #include "MainWindow/MainWindow.hpp"
+#include "MainWindow/LogUtils.hpp"
 #include "MainWindow/MainSettings.hpp"
 #include "MainWindow/IconUtils.hpp"
 #include <Pothos/System.hpp>
-#include <Poco/Logger.h>
-#include <Poco/Environment.h>
 #include <QMessageBox>
 #include <QApplication>
 #include <QDir>
 #include <stdexcept>
 #include <cstdlib> //EXIT_FAILURE
 
-static void myQLogHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
-{
-    Poco::Message::Priority prio(Poco::Message::PRIO_INFORMATION);
-    switch (type) {
-    case QtDebugMsg: prio = Poco::Message::PRIO_DEBUG; break;
-    #if QT_VERSION >= QT_VERSION_CHECK(5, 5, 0)
-    case QtInfoMsg: prio = Poco::Message::PRIO_INFORMATION; break;
-    #endif
-    case QtWarningMsg: prio = Poco::Message::PRIO_WARNING; break;
-    case QtCriticalMsg: prio = Poco::Message::PRIO_CRITICAL; break;
-    case QtFatalMsg: prio = Poco::Message::PRIO_FATAL; break;
-    }
-    const Poco::Message message(context.category, msg.toStdString(), prio, context.file, context.line);
-    Poco::Logger::get(context.category).log(message);
-}
-
-struct MyScopedSyslogListener
-{
-    MyScopedSyslogListener(void)
-    {
-        const auto port = Pothos::System::Logger::startSyslogListener();
-        //FIXME listener server supports IPv4 only; must forward to IPv4
-        Poco::Environment::set("POTHOS_SYSLOG_ADDR", "127.0.0.1:"+port);
-    }
-    ~MyScopedSyslogListener(void)
-    {
-        Pothos::System::Logger::stopSyslogListener();
-    }
-};
-
 int main(int argc, char **argv)
 {
     qInstallMessageHandler(myQLogHandler);
@@ -0,0 +1,132 @@
+// Copyright (c) 2026-2026 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "MainWindow/MainWindow.hpp"
+#include "MainWindow/LogUtils.hpp"
+#include "GraphEditor/GraphEditorTabs.hpp"
+#include "GraphEditor/GraphEditor.hpp"
+#include "BlockTree/BlockCache.hpp"
+#include <Pothos/System.hpp>
+#include <QCommandLineParser>
+#include <QApplication>
+#include <QFileInfo>
+#include <QTimer>
+#include <QEventLoop>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrent>
+#include <QDir>
+#include <iostream>
+#include <atomic>
+#include <csignal>
+#include <cstdlib> //EXIT_FAILURE
+#include <functional> //std::bind
+
+/***********************************************************************
+ * Headless topology runner:
+ * Load a topology through the same graph editor and eval engine as
+ * the GUI, activate it without showing a window, and run until the
+ * process receives an interrupt or termination signal.
+ **********************************************************************/
+
+static const int SIGNAL_POLL_INTERVAL_MS = 100;
+
+static std::atomic<bool> stopRequested(false);
+
+static void handleStopSignal(int)
+{
+    stopRequested = true;
+}
+
+int main(int argc, char **argv)
+{
+    qInstallMessageHandler(myQLogHandler);
+    MyScopedSyslogListener syslogListener;
+
+    //graph widgets still need a platform, render them off screen
+    if (not qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    //the application names select the same settings as the GUI (affinity zones)
+    QApplication app(argc, argv);
+    app.setApplicationName("Pothos");
+    app.setOrganizationName("PothosWare");
+    app.setOrganizationDomain("www.pothosware.com");
+    app.setApplicationVersion(QString::fromStdString(Pothos::System::getApiVersion()));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Run a Pothos Flow topology without the graphical interface");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("file", "The topology file (*.pothos) to run");
+    QCommandLineOption statsOption("stats", "Print the topology stats as JSON every <seconds>", "seconds", "0");
+    parser.addOption(statsOption);
+    parser.process(app);
+
+    const auto args = parser.positionalArguments();
+    if (args.size() != 1) parser.showHelp(EXIT_FAILURE);
+    const auto filePath = QDir(args.at(0)).absolutePath();
+    if (not QFileInfo(filePath).isFile())
+    {
+        std::cerr << "File " << filePath.toStdString() << " does not exist" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const auto statsIntervalSec = parser.value(statsOption).toDouble();
+
+    std::signal(SIGINT, &handleStopSignal);
+    std::signal(SIGTERM, &handleStopSignal);
+
+    POTHOS_EXCEPTION_TRY
+    {
+        //create the main window without showing it
+        MainWindow mainWindow(nullptr, true/*headless*/);
+
+        //the signal handler cannot call into Qt, poll for the stop request
+        QEventLoop blockCacheLoop;
+        QTimer signalTimer;
+        QObject::connect(&signalTimer, &QTimer::timeout, [&](void)
+        {
+            if (not stopRequested) return;
+            blockCacheLoop.quit();
+            app.quit();
+        });
+        signalTimer.start(SIGNAL_POLL_INTERVAL_MS);
+
+        //wait for the block descriptions from the hosts,
+        //otherwise the blocks load with placeholder descriptions
+        QObject::connect(BlockCache::global(), &BlockCache::blockDescReady, &blockCacheLoop, &QEventLoop::quit);
+        if (BlockCache::global()->isUpdatePending()) blockCacheLoop.exec();
+        if (stopRequested) return EXIT_SUCCESS;
+
+        //load and activate the topology
+        auto editor = mainWindow.getEditorTabs()->openFile(filePath);
+        if (not editor->isTopologyActive()) editor->setTopologyActive(true);
+
+        //periodically dump the topology stats,
+        //query off of the gui thread like the stats dialog does,
+        //since the eval thread may be waiting on the gui thread
+        QTimer statsTimer;
+        QFutureWatcher<QByteArray> statsWatcher;
+        QObject::connect(&statsTimer, &QTimer::timeout, [&](void)
+        {
+            if (statsWatcher.isRunning()) return; //previous query still pending
+            statsWatcher.setFuture(QtConcurrent::run(std::bind(&GraphEditor::getTopologyJSONStats, editor)));
+        });
+        QObject::connect(&statsWatcher, &QFutureWatcher<QByteArray>::finished, [&](void)
+        {
+            const auto jsonStats = statsWatcher.result();
+            if (not jsonStats.isNull()) std::cout << jsonStats.constData() << std::endl;
+        });
+        if (statsIntervalSec > 0.0) statsTimer.start(int(statsIntervalSec*1000));
+
+        //run until interrupted, the main window destructor tears down the topology
+        const int ret = app.exec();
+        statsTimer.stop();
+        statsWatcher.waitForFinished();
+        return ret;
+    }
+    POTHOS_EXCEPTION_CATCH (const Pothos::Exception &ex)
+    {
+        std::cerr << "PothosFlowHeadless error: " << ex.displayText() << std::endl;
+        return EXIT_FAILURE;
+    }
+}